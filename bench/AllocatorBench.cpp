@@ -0,0 +1,83 @@
+#include "Benchmark.hpp"
+
+#include "Allocators.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+
+// what a frame typically allocates: a few hundred small arrays.
+constexpr unsigned int allocationsPerFrame = 256;
+constexpr std::size_t allocationSize = 48;
+
+struct Node
+{
+	glm::mat4 transform;
+	Node *next;
+};
+
+} // namespace
+
+void
+runAllocatorBenchmarks(BenchRunner &runner)
+{
+	runner.run("allocators/frame/new-delete",
+			   [](uint64_t iterations)
+			   {
+				   void *pointers[allocationsPerFrame];
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   for (void *&pointer : pointers)
+					   {
+						   pointer = ::operator new(allocationSize);
+						   doNotOptimize(pointer);
+					   }
+					   for (void *pointer : pointers)
+						   ::operator delete(pointer);
+				   }
+			   });
+
+	LinearArena arena(allocationsPerFrame * allocationSize);
+	runner.run("allocators/frame/arena",
+			   [&arena](uint64_t iterations)
+			   {
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   for (unsigned int a = 0; a < allocationsPerFrame; a++)
+						   doNotOptimize(arena.allocate(allocationSize, 16));
+					   arena.reset();
+				   }
+			   });
+
+	// objects created and destroyed in an interleaved order.
+	runner.run("allocators/objects/new-delete",
+			   [](uint64_t iterations)
+			   {
+				   std::vector<std::unique_ptr<Node>> nodes(64);
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   nodes[i * 37 % nodes.size()] = std::make_unique<Node>();
+					   doNotOptimize(nodes[i * 37 % nodes.size()].get());
+				   }
+			   });
+
+	Pool<Node> pool;
+	runner.run("allocators/objects/pool",
+			   [&pool](uint64_t iterations)
+			   {
+				   std::vector<Node *> nodes(64, nullptr);
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   Node *&node = nodes[i * 37 % nodes.size()];
+					   if (node != nullptr)
+						   pool.destroy(node);
+					   node = pool.create();
+					   doNotOptimize(node);
+				   }
+				   for (Node *node : nodes)
+					   if (node != nullptr)
+						   pool.destroy(node);
+			   });
+}
@@ -0,0 +1,141 @@
+#include "Benchmark.hpp"
+// generated at build time, see bench/Revision.cmake.
+#include "BenchRevision.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <thread>
+
+namespace
+{
+
+double
+timeBody(const BenchFunction &body, uint64_t iterations)
+{
+	auto start = std::chrono::steady_clock::now();
+	body(iterations);
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double>(end - start).count();
+}
+
+void
+writeEscaped(FILE *file, const std::string &text)
+{
+	std::fputc('"', file);
+	for (char c : text)
+	{
+		if (c == '"' || c == '\\')
+			std::fputc('\\', file);
+		std::fputc(c, file);
+	}
+	std::fputc('"', file);
+}
+
+} // namespace
+
+BenchRunner::BenchRunner(const Settings &settings) : settings(settings) {}
+
+bool
+BenchRunner::matches(const std::string &name) const
+{
+	return settings.filter.empty() ||
+		   name.find(settings.filter) != std::string::npos;
+}
+
+void
+BenchRunner::run(const std::string &name, const BenchFunction &body,
+				 double workPerOp, const char *workUnit)
+{
+	if (!matches(name))
+		return;
+
+	// grow the iteration count until a run is long enough to extrapolate.
+	uint64_t iterations = 1;
+	double elapsed = timeBody(body, iterations);
+	while (elapsed < settings.minTime / 10.0 && iterations < (1ull << 40))
+	{
+		iterations *= elapsed > 0.0 ? 10 : 100;
+		elapsed = timeBody(body, iterations);
+	}
+	double perOp = elapsed / iterations;
+	iterations = std::max<uint64_t>(
+		1, static_cast<uint64_t>(settings.minTime / std::max(perOp, 1e-12)));
+
+	std::vector<double> samples;
+	for (unsigned int i = 0; i < std::max(1u, settings.repetitions); i++)
+		samples.push_back(timeBody(body, iterations) * 1e9 / iterations);
+	std::sort(samples.begin(), samples.end());
+
+	BenchResult result;
+	result.name = name;
+	result.iterations = iterations;
+	result.nsPerOp = samples[samples.size() / 2];
+	result.nsPerOpMin = samples.front();
+	result.nsPerOpMax = samples.back();
+	if (workUnit != nullptr && workPerOp > 0.0)
+		result.counters.emplace_back(std::string(workUnit) + "/s",
+									 workPerOp * 1e9 / result.nsPerOp);
+
+	std::string counters;
+	for (const auto &counter : result.counters)
+		counters += fmt::format("  {:.2f} {}", counter.second, counter.first);
+	spdlog::info("{:<48} {:>12.2f} ns/op  ({} iterations){}", name,
+				 result.nsPerOp, iterations, counters);
+
+	benchResults.push_back(std::move(result));
+}
+
+bool
+BenchRunner::writeJson(const std::string &path) const
+{
+	FILE *file = std::fopen(path.c_str(), "w");
+	if (file == nullptr)
+	{
+		spdlog::error("Failed to open {} for writing", path);
+		return false;
+	}
+
+	char date[32];
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+	std::fprintf(file, "{\n  \"context\": {\n");
+	std::fprintf(file, "    \"revision\": \"%s\",\n", BENCH_GIT_REVISION);
+	std::fprintf(file, "    \"date\": \"%s\",\n", date);
+	std::fprintf(file, "    \"compiler\": ");
+	writeEscaped(file, __VERSION__);
+	std::fprintf(file, ",\n    \"hardware_threads\": %u,\n",
+				 std::thread::hardware_concurrency());
+#ifdef NDEBUG
+	std::fprintf(file, "    \"optimized\": true\n  },\n");
+#else
+	std::fprintf(file, "    \"optimized\": false\n  },\n");
+#endif
+
+	std::fprintf(file, "  \"benchmarks\": [");
+	for (std::size_t i = 0; i < benchResults.size(); i++)
+	{
+		const BenchResult &result = benchResults[i];
+		std::fprintf(file, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+		writeEscaped(file, result.name);
+		std::fprintf(file,
+					 ", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+					 "\"ns_per_op_min\": %.3f, \"ns_per_op_max\": %.3f",
+					 static_cast<unsigned long long>(result.iterations),
+					 result.nsPerOp, result.nsPerOpMin, result.nsPerOpMax);
+		for (const auto &counter : result.counters)
+		{
+			std::fprintf(file, ", ");
+			writeEscaped(file, counter.first);
+			std::fprintf(file, ": %.3f", counter.second);
+		}
+		std::fprintf(file, "}");
+	}
+	std::fprintf(file, "\n  ]\n}\n");
+	std::fclose(file);
+	return true;
+}
@@ -0,0 +1,95 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// keeps the compiler from optimizing a computed value away.
+template <typename T>
+inline void
+doNotOptimize(const T &value)
+{
+	asm volatile("" : : "r,m"(value) : "memory");
+}
+
+struct BenchResult
+{
+	std::string name;
+	uint64_t iterations = 0; // operations per repetition.
+	double nsPerOp = 0.0;	 // median over the repetitions.
+	double nsPerOpMin = 0.0;
+	double nsPerOpMax = 0.0;
+	// derived throughput, e.g. {"MP/s", 48.2}.
+	std::vector<std::pair<std::string, double>> counters;
+};
+
+// a benchmark body performs `iterations` operations, the runner picks the
+// count so that one repetition lasts at least Settings::minTime.
+using BenchFunction = std::function<void(uint64_t iterations)>;
+
+class BenchRunner final
+{
+  public:
+	struct Settings
+	{
+		double minTime = 0.1; // seconds per repetition.
+		unsigned int repetitions = 5;
+		std::string filter; // substring a benchmark name has to contain.
+	};
+
+	explicit BenchRunner(const Settings &settings);
+
+	bool matches(const std::string &name) const;
+
+	// runs the benchmark right away. `workPerOp` units of `workUnit` (e.g.
+	// megapixels) are processed by one operation, which adds a throughput
+	// counter to the result.
+	void run(const std::string &name, const BenchFunction &body,
+			 double workPerOp = 0.0, const char *workUnit = nullptr);
+
+	const std::vector<BenchResult> &results() const { return benchResults; }
+
+	bool writeJson(const std::string &path) const;
+
+  private:
+	Settings settings;
+	std::vector<BenchResult> benchResults;
+};
+
+void
+runMathBenchmarks(BenchRunner &runner);
+// the glm/simd/matrix.h kernels, a no-op on targets without sse2. `count`
+// has to be a power of two.
+void
+runSimdMatrixBenchmarks(BenchRunner &runner, const glm::mat4 *a,
+						const glm::mat4 *b, std::size_t count);
+void
+runSceneBenchmarks(BenchRunner &runner);
+void
+runImageBenchmarks(BenchRunner &runner);
+// scheduling overhead and parallelFor throughput of the job system.
+void
+runJobBenchmarks(BenchRunner &runner);
+// iteration, spawn/destroy and archetype moves of the ECS world.
+void
+runEcsBenchmarks(BenchRunner &runner);
+// SceneGraph updates of a forest with few and with many dirty subtrees.
+void
+runSceneGraphBenchmarks(BenchRunner &runner);
+// TransformSystem::update from one thread up to all hardware threads.
+void
+runTransformBenchmarks(BenchRunner &runner);
+// per frame arena and object pool against the global heap.
+void
+runAllocatorBenchmarks(BenchRunner &runner);
+// needs a GL context, returns false when none could be created.
+bool
+runGLBenchmarks(BenchRunner &runner);
+
+#endif // BENCHMARK_H
@@ -0,0 +1,146 @@
+#include "Benchmark.hpp"
+
+#include "Ecs.hpp"
+#include "JobSystem.hpp"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+
+struct Position
+{
+	glm::vec3 value;
+};
+
+struct Velocity
+{
+	glm::vec3 value;
+};
+
+struct Health
+{
+	float value;
+};
+
+// an extra tag splitting the entities over a second archetype.
+struct Frozen
+{
+};
+
+constexpr std::size_t entityCount = 100000;
+
+void
+populate(World &world)
+{
+	for (std::size_t i = 0; i < entityCount; i++)
+	{
+		Position position{glm::vec3(float(i), 0.0f, 0.0f)};
+		Velocity velocity{glm::vec3(1.0f, 0.5f, 0.25f)};
+		if (i % 4 == 0)
+			world.create(position, velocity, Health{100.0f}, Frozen{});
+		else
+			world.create(position, velocity, Health{100.0f});
+	}
+}
+
+} // namespace
+
+void
+runEcsBenchmarks(BenchRunner &runner)
+{
+	// one operation integrates every entity once.
+	{
+		World world;
+		populate(world);
+		runner.run(
+			"ecs/iterate/chunks",
+			[&world](uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+					world.eachChunk<Position, Velocity>(
+						[](std::size_t count, const Entity *,
+						   Position *positions, Velocity *velocities)
+						{
+							for (std::size_t e = 0; e < count; e++)
+								positions[e].value +=
+									velocities[e].value * (1.0f / 60.0f);
+						});
+			},
+			entityCount / 1e6, "Mentities");
+
+		runner.run(
+			"ecs/iterate/entities",
+			[&world](uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+					world.each<Position, Velocity>(
+						[](Entity, Position &position, Velocity &velocity)
+						{ position.value += velocity.value * (1.0f / 60.0f); });
+			},
+			entityCount / 1e6, "Mentities");
+
+		JobSystem jobs;
+		runner.run(
+			"ecs/iterate/parallel",
+			[&](uint64_t iterations)
+			{
+				for (uint64_t i = 0; i < iterations; i++)
+					world.parallelEach<Position, Velocity>(
+						jobs,
+						[](Entity, Position &position, Velocity &velocity)
+						{ position.value += velocity.value * (1.0f / 60.0f); });
+			},
+			entityCount / 1e6, "Mentities");
+	}
+
+	// one operation is one entity created and destroyed again, with a warm
+	// world so chunks come from the pool.
+	{
+		World world;
+		populate(world);
+		std::vector<Entity> spawned(1024);
+		runner.run("ecs/spawn-destroy",
+				   [&](uint64_t iterations)
+				   {
+					   for (uint64_t done = 0; done < iterations;)
+					   {
+						   std::size_t count = std::min<uint64_t>(
+							   spawned.size(), iterations - done);
+						   for (std::size_t i = 0; i < count; i++)
+							   spawned[i] = world.create(
+								   Position{glm::vec3(0.0f)},
+								   Velocity{glm::vec3(1.0f)}, Health{1.0f});
+						   for (std::size_t i = 0; i < count; i++)
+							   world.destroy(spawned[i]);
+						   done += count;
+					   }
+				   });
+
+		// moving between archetypes, one operation adds and removes a tag.
+		std::vector<Entity> entities;
+		world.each<Health>([&entities](Entity entity, Health &)
+						   { entities.push_back(entity); });
+		runner.run("ecs/add-remove",
+				   [&](uint64_t iterations)
+				   {
+					   for (uint64_t i = 0; i < iterations; i++)
+					   {
+						   Entity entity = entities[i % entities.size()];
+						   if (world.has<Frozen>(entity))
+						   {
+							   world.remove<Frozen>(entity);
+							   world.add<Frozen>(entity);
+						   }
+						   else
+						   {
+							   world.add<Frozen>(entity);
+							   world.remove<Frozen>(entity);
+						   }
+					   }
+				   });
+	}
+}
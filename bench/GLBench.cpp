@@ -0,0 +1,152 @@
+#include "Benchmark.hpp"
+#include "Shader.hpp"
+#include "UploadScheduler.hpp"
+#include "Window.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <vector>
+
+namespace
+{
+
+void
+runUniformBenchmarks(BenchRunner &runner)
+{
+	Shader shader(SOURCE_DIR "shader.vert", SOURCE_DIR "shader.frag");
+	shader.use();
+
+	std::vector<glm::mat4> models(256);
+	for (std::size_t i = 0; i < models.size(); i++)
+		models[i] = glm::translate(glm::mat4(1.0f), glm::vec3(i, 0.0f, 0.0f));
+
+	// what the render loop does: a name lookup for every set.
+	runner.run("gl/uniform/setMat4_by_name",
+			   [&](uint64_t iterations)
+			   {
+				   for (uint64_t i = 0; i < iterations; i++)
+					   shader.setMat4("model", models[i & 255]);
+				   glFinish();
+			   });
+
+	GLint location = glGetUniformLocation(shader.ID, "model");
+	runner.run("gl/uniform/setMat4_cached_location",
+			   [&](uint64_t iterations)
+			   {
+				   for (uint64_t i = 0; i < iterations; i++)
+					   glUniformMatrix4fv(location, 1, GL_FALSE,
+										  &models[i & 255][0][0]);
+				   glFinish();
+			   });
+}
+
+void
+runUploadBenchmarks(BenchRunner &runner, std::size_t size, const char *label)
+{
+	std::vector<unsigned char> source(size, 0x5a);
+	GLuint buffer;
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_ARRAY_BUFFER, buffer);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+
+	std::string prefix = std::string("gl/upload/") + label + "/";
+	double megabytes = size / 1e6;
+
+	// new storage with the data on every upload.
+	runner.run(
+		prefix + "buffer_data",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+				glBufferData(GL_ARRAY_BUFFER, size, source.data(),
+							 GL_STREAM_DRAW);
+			glFinish();
+		},
+		megabytes, "MB");
+
+	// in place update, may wait for the gpu to release the storage.
+	runner.run(
+		prefix + "buffer_sub_data",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+				glBufferSubData(GL_ARRAY_BUFFER, 0, size, source.data());
+			glFinish();
+		},
+		megabytes, "MB");
+
+	// orphan the old storage first so the driver never has to wait.
+	runner.run(
+		prefix + "orphan_sub_data",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+				glBufferSubData(GL_ARRAY_BUFFER, 0, size, source.data());
+			}
+			glFinish();
+		},
+		megabytes, "MB");
+
+	runner.run(
+		prefix + "map_invalidate",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				void *target = glMapBufferRange(
+					GL_ARRAY_BUFFER, 0, size,
+					GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+				if (target != nullptr)
+					std::memcpy(target, source.data(), size);
+				glUnmapBuffer(GL_ARRAY_BUFFER);
+			}
+			glFinish();
+		},
+		megabytes, "MB");
+
+	// what the asset uploads do: 64 KiB chunks through the scheduler, one
+	// process() per frame until the buffer is in.
+	UploadScheduler uploads(64 * 1024);
+	TrackedStdAllocator<unsigned char> allocator(trackedAllocator("uploads"));
+	runner.run(
+		prefix + "scheduled_chunks",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				UploadBytes bytes(source.begin(), source.end(), allocator);
+				uploads.uploadBuffer(buffer, 0, std::move(bytes),
+									 UploadPriority::Visible);
+				while (uploads.pending())
+					uploads.process();
+			}
+			glFinish();
+		},
+		megabytes, "MB");
+
+	glDeleteBuffers(1, &buffer);
+}
+
+} // namespace
+
+bool
+runGLBenchmarks(BenchRunner &runner)
+{
+	GLFWwindow *window = createWindow(64, 64, "bench", false);
+	if (window == NULL)
+		return false;
+	spdlog::info("GL renderer: {}",
+				 reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+
+	runUniformBenchmarks(runner);
+	runUploadBenchmarks(runner, 64 * 1024, "64KiB");
+	runUploadBenchmarks(runner, 4 * 1024 * 1024, "4MiB");
+
+	glfwDestroyWindow(window);
+	glfwTerminate();
+	return true;
+}
@@ -0,0 +1,67 @@
+#include "Benchmark.hpp"
+
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+namespace
+{
+
+std::vector<unsigned char>
+readFile(const char *path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<unsigned char>(std::istreambuf_iterator<char>(file),
+									  std::istreambuf_iterator<char>());
+}
+
+void
+runDecode(BenchRunner &runner, const char *name, const char *path)
+{
+	if (!runner.matches(name))
+		return;
+
+	std::vector<unsigned char> encoded = readFile(path);
+	int width, height, channels;
+	if (encoded.empty() ||
+		!stbi_info_from_memory(encoded.data(), static_cast<int>(encoded.size()),
+							   &width, &height, &channels))
+	{
+		spdlog::error("Failed to read image {}", path);
+		return;
+	}
+
+	runner.run(
+		name,
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				int w, h, c;
+				unsigned char *pixels = stbi_load_from_memory(
+					encoded.data(), static_cast<int>(encoded.size()), &w, &h,
+					&c, 0);
+				doNotOptimize(pixels);
+				stbi_image_free(pixels);
+			}
+		},
+		width * height / 1e6, "MP");
+}
+
+} // namespace
+
+void
+runImageBenchmarks(BenchRunner &runner)
+{
+	// same settings as the texture loading in main().
+	stbi_set_flip_vertically_on_load(true);
+
+	runDecode(runner, "stbi/decode/jpeg/container", ASSETS_DIR "container.jpg");
+	runDecode(runner, "stbi/decode/jpeg/awesomeface",
+			  ASSETS_DIR "awesomeface.jpg");
+	runDecode(runner, "stbi/decode/png/awesomeface",
+			  ASSETS_DIR "awesomeface.png");
+}
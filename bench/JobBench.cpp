@@ -0,0 +1,71 @@
+#include "Benchmark.hpp"
+
+#include "JobSystem.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+void
+runJobBenchmarks(BenchRunner &runner)
+{
+	JobSystem jobs;
+
+	// scheduling overhead: one operation is one empty job run to completion.
+	constexpr unsigned int batch = 1024;
+	runner.run("jobs/empty", [&jobs](uint64_t iterations)
+			   {
+				   JobCounter counter;
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   jobs.run([]() {}, &counter);
+					   if ((i + 1) % batch == 0)
+						   jobs.wait(counter);
+				   }
+				   jobs.wait(counter);
+			   });
+
+	// chains of dependent jobs, one operation is one link.
+	constexpr unsigned int chainLength = 64;
+	runner.run("jobs/chain", [&jobs](uint64_t iterations)
+			   {
+				   for (uint64_t done = 0; done < iterations;
+						done += chainLength)
+				   {
+					   // job k waits for links[k] and completes links[k + 1].
+					   JobCounter links[chainLength + 1];
+					   uint64_t length =
+						   std::min<uint64_t>(chainLength, iterations - done);
+					   for (unsigned int k = 0; k < length; k++)
+						   jobs.runAfter(links[k], []() {}, &links[k + 1]);
+					   for (JobCounter &link : links)
+						   jobs.wait(link);
+				   }
+			   });
+
+	// parallelFor over independent matrix builds, one operation builds all.
+	constexpr std::size_t itemCount = 100000;
+	std::vector<glm::mat4> matrices(itemCount);
+	runner.run(
+		"jobs/parallel-for/" + std::to_string(jobs.threadCount()) + "-threads",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+				jobs.parallelFor(
+					0, itemCount, 0,
+					[&](std::size_t first, std::size_t last)
+					{
+						for (std::size_t i = first; i < last; i++)
+						{
+							glm::mat4 model = glm::translate(
+								glm::mat4(1.0f), glm::vec3(float(i)));
+							matrices[i] = glm::rotate(model, float(i),
+													  glm::vec3(0, 1, 0));
+						}
+					});
+			doNotOptimize(matrices.data());
+		},
+		itemCount / 1e6, "Mitems");
+}
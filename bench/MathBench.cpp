@@ -0,0 +1,103 @@
+#include "Benchmark.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <random>
+
+namespace
+{
+
+// enough inputs that the results cannot be hoisted out of the loop, few
+// enough that they stay in l1.
+constexpr std::size_t setSize = 256;
+constexpr std::size_t setMask = setSize - 1;
+
+struct MatrixSet
+{
+	glm::mat4 a[setSize];
+	glm::mat4 b[setSize];
+	glm::vec3 eyes[setSize];
+	float angles[setSize];
+};
+
+const MatrixSet &
+matrixSet()
+{
+	static MatrixSet set = []()
+	{
+		MatrixSet set;
+		std::mt19937 engine(42);
+		std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+		for (std::size_t i = 0; i < setSize; i++)
+		{
+			glm::vec3 axis = glm::normalize(
+				glm::vec3(value(engine), value(engine), value(engine)) +
+				glm::vec3(0.0f, 2.0f, 0.0f));
+			glm::vec3 offset(value(engine), value(engine), value(engine));
+			// rotations plus translations, always invertible.
+			set.a[i] = glm::translate(
+				glm::rotate(glm::mat4(1.0f), value(engine) * 3.0f, axis),
+				offset * 10.0f);
+			set.b[i] = glm::rotate(glm::mat4(1.0f), value(engine), axis);
+			set.eyes[i] = offset * 20.0f + glm::vec3(0.0f, 0.0f, 30.0f);
+			set.angles[i] = 30.0f + 30.0f * (value(engine) + 1.0f);
+		}
+		return set;
+	}();
+	return set;
+}
+
+} // namespace
+
+void
+runMathBenchmarks(BenchRunner &runner)
+{
+	const MatrixSet &set = matrixSet();
+
+	runner.run("glm/mat4_multiply/scalar",
+			   [&](uint64_t iterations)
+			   {
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   glm::mat4 r = set.a[i & setMask] * set.b[i & setMask];
+					   doNotOptimize(r);
+				   }
+			   });
+
+	runner.run("glm/mat4_inverse/scalar",
+			   [&](uint64_t iterations)
+			   {
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   glm::mat4 r = glm::inverse(set.a[i & setMask]);
+					   doNotOptimize(r);
+				   }
+			   });
+
+	runSimdMatrixBenchmarks(runner, set.a, set.b, setSize);
+
+	runner.run("glm/lookAt",
+			   [&](uint64_t iterations)
+			   {
+				   const glm::vec3 up(0.0f, 1.0f, 0.0f);
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   const glm::vec3 &eye = set.eyes[i & setMask];
+					   glm::mat4 r = glm::lookAt(eye, glm::vec3(0.0f), up);
+					   doNotOptimize(r);
+				   }
+			   });
+
+	runner.run("glm/perspective",
+			   [&](uint64_t iterations)
+			   {
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   glm::mat4 r = glm::perspective(
+						   glm::radians(set.angles[i & setMask]),
+						   800.0f / 600.0f, 0.1f, 100.0f);
+					   doNotOptimize(r);
+				   }
+			   });
+}
@@ -0,0 +1,21 @@
+# writes BenchRevision.hpp with the current git revision. runs on every
+# build of the benchmarks, the header is only rewritten when the revision
+# changed, so an unchanged revision rebuilds nothing.
+execute_process(
+    COMMAND git rev-parse --short HEAD
+    WORKING_DIRECTORY ${SOURCE_DIR}
+    OUTPUT_VARIABLE BENCH_GIT_REVISION
+    OUTPUT_STRIP_TRAILING_WHITESPACE
+    ERROR_QUIET
+)
+if (NOT BENCH_GIT_REVISION)
+    set(BENCH_GIT_REVISION "unknown")
+endif()
+
+set(CONTENT "#define BENCH_GIT_REVISION \"${BENCH_GIT_REVISION}\"\n")
+if (EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} CURRENT)
+endif()
+if (NOT CURRENT STREQUAL CONTENT)
+    file(WRITE ${OUTPUT} "${CONTENT}")
+endif()
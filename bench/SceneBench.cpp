@@ -0,0 +1,37 @@
+#include "Benchmark.hpp"
+
+#include "SceneGenerator.hpp"
+
+void
+runSceneBenchmarks(BenchRunner &runner)
+{
+	const SceneDistribution distributions[] = {
+		SceneDistribution::Uniform, SceneDistribution::Clustered,
+		SceneDistribution::Grid, SceneDistribution::City};
+
+	// one operation generates a whole scene, reported as objects per second.
+	constexpr std::size_t objectCount = 100000;
+	for (SceneDistribution distribution : distributions)
+	{
+		std::string name = "scene/generate/";
+		name += sceneDistributionName(distribution);
+		runner.run(
+			name,
+			[distribution](uint64_t iterations)
+			{
+				SceneDesc desc;
+				desc.objectCount = objectCount;
+				desc.distribution = distribution;
+				desc.meshVariety = 2;
+				desc.materialVariety = 8;
+				desc.dynamicRatio = 0.1f;
+				for (uint64_t i = 0; i < iterations; i++)
+				{
+					desc.seed = static_cast<uint32_t>(i);
+					Scene scene = generateScene(desc);
+					doNotOptimize(scene.objects.data());
+				}
+			},
+			objectCount / 1e6, "Mobjects");
+	}
+}
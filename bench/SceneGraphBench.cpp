@@ -0,0 +1,124 @@
+#include "Benchmark.hpp"
+
+#include "JobSystem.hpp"
+#include "SceneGraph.hpp"
+
+#include <vector>
+
+namespace
+{
+
+// 256 trees, four children per node, four levels below the root.
+constexpr unsigned int treeCount = 256;
+constexpr unsigned int branching = 4;
+constexpr unsigned int depth = 4;
+
+void
+buildForest(SceneGraph &graph, std::vector<NodeId> &roots,
+			std::vector<NodeId> &leaves)
+{
+	for (unsigned int tree = 0; tree < treeCount; tree++)
+	{
+		LocalTransform local;
+		local.position = glm::vec3(float(tree), 0.0f, 0.0f);
+		std::vector<NodeId> level = {graph.addNode(noParent, local)};
+		roots.push_back(level.front());
+		for (unsigned int d = 0; d < depth; d++)
+		{
+			std::vector<NodeId> next;
+			for (NodeId parent : level)
+				for (unsigned int c = 0; c < branching; c++)
+				{
+					local.position = glm::vec3(0.0f, 1.0f, float(c));
+					next.push_back(graph.addNode(parent, local));
+				}
+			level.swap(next);
+		}
+		leaves.insert(leaves.end(), level.begin(), level.end());
+	}
+	graph.update();
+}
+
+} // namespace
+
+void
+runSceneGraphBenchmarks(BenchRunner &runner)
+{
+	SceneGraph graph;
+	std::vector<NodeId> roots, leaves;
+	buildForest(graph, roots, leaves);
+	double nodes = graph.nodeCount() / 1e6;
+
+	// moves every `stride`th node of `moved`, then updates the graph.
+	auto touch = [&graph](const std::vector<NodeId> &moved, std::size_t stride,
+						  uint64_t iteration)
+	{
+		for (std::size_t i = iteration % stride; i < moved.size(); i += stride)
+		{
+			LocalTransform local = graph.local(moved[i]);
+			local.rotation = glm::angleAxis(iteration * 0.01f,
+											glm::vec3(0.0f, 1.0f, 0.0f));
+			graph.setLocal(moved[i], local);
+		}
+	};
+
+	// the throughput counters are relative to the whole graph.
+	runner.run(
+		"scene-graph/update/all",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				touch(roots, 1, i);
+				graph.update();
+			}
+		},
+		nodes, "Mnodes");
+
+	JobSystem jobs;
+	runner.run(
+		"scene-graph/update/all-parallel",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				touch(roots, 1, i);
+				graph.update(jobs);
+			}
+		},
+		nodes, "Mnodes");
+
+	runner.run(
+		"scene-graph/update/roots-1pct",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				touch(roots, 100, i);
+				graph.update();
+			}
+		},
+		nodes, "Mnodes");
+
+	runner.run(
+		"scene-graph/update/leaves-1pct",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				touch(leaves, 100, i);
+				graph.update();
+			}
+		},
+		nodes, "Mnodes");
+
+	// nothing moved, the cost of scanning the dirty flags.
+	runner.run(
+		"scene-graph/update/clean",
+		[&](uint64_t iterations)
+		{
+			for (uint64_t i = 0; i < iterations; i++)
+				graph.update();
+		},
+		nodes, "Mnodes");
+}
@@ -0,0 +1,75 @@
+// glm only exposes glm/simd/matrix.h with intrinsics enabled, the setting is
+// kept to this translation unit so every other glm::mat4 stays scalar.
+#define GLM_FORCE_INTRINSICS
+#include "Benchmark.hpp"
+
+#include <glm/simd/matrix.h>
+
+#include <vector>
+
+#if GLM_ARCH & GLM_ARCH_SSE2_BIT
+
+namespace
+{
+
+struct alignas(16) SimdMatrix
+{
+	glm_vec4 columns[4];
+};
+
+SimdMatrix
+toSimd(const glm::mat4 &m)
+{
+	SimdMatrix result;
+	for (int c = 0; c < 4; c++)
+		result.columns[c] = _mm_loadu_ps(&m[c][0]);
+	return result;
+}
+
+} // namespace
+
+void
+runSimdMatrixBenchmarks(BenchRunner &runner, const glm::mat4 *a,
+						const glm::mat4 *b, std::size_t count)
+{
+	std::vector<SimdMatrix> simdA(count), simdB(count);
+	for (std::size_t i = 0; i < count; i++)
+	{
+		simdA[i] = toSimd(a[i]);
+		simdB[i] = toSimd(b[i]);
+	}
+	const std::size_t mask = count - 1;
+
+	runner.run("glm/mat4_multiply/simd",
+			   [&](uint64_t iterations)
+			   {
+				   SimdMatrix r;
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   glm_mat4_mul(simdA[i & mask].columns,
+									simdB[i & mask].columns, r.columns);
+					   doNotOptimize(r);
+				   }
+			   });
+
+	runner.run("glm/mat4_inverse/simd",
+			   [&](uint64_t iterations)
+			   {
+				   SimdMatrix r;
+				   for (uint64_t i = 0; i < iterations; i++)
+				   {
+					   glm_mat4_inverse(simdA[i & mask].columns, r.columns);
+					   doNotOptimize(r);
+				   }
+			   });
+}
+
+#else
+
+void
+runSimdMatrixBenchmarks(BenchRunner &, const glm::mat4 *, const glm::mat4 *,
+						std::size_t)
+{
+}
+
+#endif
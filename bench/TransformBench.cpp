@@ -0,0 +1,58 @@
+#include "Benchmark.hpp"
+
+#include "JobSystem.hpp"
+#include "SceneGenerator.hpp"
+#include "TransformSystem.hpp"
+
+#include <string>
+#include <thread>
+
+void
+runTransformBenchmarks(BenchRunner &runner)
+{
+	// all objects animated, every update recomputes every matrix.
+	constexpr std::size_t objectCount = 200000;
+	SceneDesc desc;
+	desc.objectCount = objectCount;
+	desc.distribution = SceneDistribution::City;
+	desc.meshVariety = 2;
+	desc.materialVariety = 8;
+	desc.dynamicRatio = 1.0f;
+	Scene dynamicScene = generateScene(desc);
+	// the usual case, the dirty flags skip the static 90%.
+	desc.dynamicRatio = 0.1f;
+	Scene mixedScene = generateScene(desc);
+
+	// the scaling curve: 1, 2, 4, ... threads up to the hardware threads.
+	unsigned int maxThreads = std::max(1u, std::thread::hardware_concurrency());
+	for (unsigned int threads = 1;; threads = std::min(threads * 2, maxThreads))
+	{
+		std::string suffix = "/" + std::to_string(threads) + "-threads";
+		if (runner.matches("transforms/update/dynamic" + suffix) ||
+			runner.matches("transforms/update/mixed" + suffix))
+		{
+			JobSystem jobs(threads - 1);
+			for (const Scene *scene : {&dynamicScene, &mixedScene})
+			{
+				TransformSystem transforms(*scene);
+				LinearArena frame(transforms.frameBytes());
+				transforms.update(jobs, 0.0f, frame);
+				runner.run(
+					std::string("transforms/update/") +
+						(scene == &dynamicScene ? "dynamic" : "mixed") + suffix,
+					[&](uint64_t iterations)
+					{
+						for (uint64_t i = 0; i < iterations; i++)
+						{
+							frame.reset();
+							transforms.update(jobs, i / 60.0f, frame);
+						}
+						doNotOptimize(transforms.matrices().data());
+					},
+					objectCount / 1e6, "Mobjects");
+			}
+		}
+		if (threads == maxThreads)
+			break;
+	}
+}
@@ -0,0 +1,70 @@
+#include "Benchmark.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace
+{
+
+void
+printUsage(const char *program)
+{
+	spdlog::info("usage: {} [options]\n"
+				 "  --json PATH          write the results as json\n"
+				 "  --filter TEXT        only run benchmarks containing TEXT\n"
+				 "  --min-time SECONDS   minimum duration of a repetition\n"
+				 "  --repetitions N      repetitions per benchmark\n"
+				 "  --no-gl              skip the benchmarks needing a GL "
+				 "context",
+				 program);
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+	BenchRunner::Settings settings;
+	std::string jsonPath;
+	bool withGL = true;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(arg, "--json") == 0 && hasValue)
+			jsonPath = argv[++i];
+		else if (std::strcmp(arg, "--filter") == 0 && hasValue)
+			settings.filter = argv[++i];
+		else if (std::strcmp(arg, "--min-time") == 0 && hasValue)
+			settings.minTime = std::atof(argv[++i]);
+		else if (std::strcmp(arg, "--repetitions") == 0 && hasValue)
+			settings.repetitions = std::atoi(argv[++i]);
+		else if (std::strcmp(arg, "--no-gl") == 0)
+			withGL = false;
+		else
+		{
+			printUsage(argv[0]);
+			return std::strcmp(arg, "--help") == 0 ? 0 : 1;
+		}
+	}
+
+	BenchRunner runner(settings);
+	runMathBenchmarks(runner);
+	runSceneBenchmarks(runner);
+	runImageBenchmarks(runner);
+	runJobBenchmarks(runner);
+	runTransformBenchmarks(runner);
+	runEcsBenchmarks(runner);
+	runSceneGraphBenchmarks(runner);
+	runAllocatorBenchmarks(runner);
+	if (withGL && !runGLBenchmarks(runner))
+		spdlog::warn("No GL context available, skipped the GL benchmarks");
+
+	if (!jsonPath.empty() && !runner.writeJson(jsonPath))
+		return 1;
+	return 0;
+}
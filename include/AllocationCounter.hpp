@@ -0,0 +1,13 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+#include <cstdint>
+
+// counts the calls to the global operator new, which AllocationCounter.cpp
+// replaces. malloc calls of C libraries are not seen.
+uint64_t
+heapAllocationCount();
+uint64_t
+heapAllocatedBytes();
+
+#endif // ALLOCATION_COUNTER_H
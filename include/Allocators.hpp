@@ -0,0 +1,160 @@
+#ifndef ALLOCATORS_H
+#define ALLOCATORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// bump allocator over one block, everything is released at once by reset().
+// requests beyond the block fall back to the heap (and warn once) until the
+// next reset, so an undersized arena is slow but never fails.
+class LinearArena final
+{
+  public:
+	explicit LinearArena(std::size_t capacity);
+	~LinearArena();
+
+	LinearArena(const LinearArena &) = delete;
+	LinearArena &operator=(const LinearArena &) = delete;
+
+	void *allocate(std::size_t size,
+				   std::size_t align = alignof(std::max_align_t));
+
+	// uninitialized storage for `count` T.
+	template <typename T> T *allocateArray(std::size_t count)
+	{
+		return static_cast<T *>(allocate(count * sizeof(T), alignof(T)));
+	}
+
+	void reset();
+
+	std::size_t capacity() const { return size; }
+	std::size_t used() const { return offset; }
+	// most bytes used between two resets, overflow included.
+	std::size_t peak() const { return peakUsed; }
+
+  private:
+	unsigned char *block;
+	std::size_t size;
+	std::size_t offset = 0;
+	std::size_t peakUsed = 0;
+	std::size_t overflowBytes = 0;
+	std::vector<void *> overflow;
+	bool warned = false;
+};
+
+// one arena per frame in flight. beginFrame() moves to the next arena and
+// resets it, data allocated in a frame stays valid for `frames` frames.
+class FrameArena final
+{
+  public:
+	explicit FrameArena(std::size_t capacityPerFrame, unsigned int frames = 2);
+
+	void beginFrame();
+	LinearArena &current() { return *arenas[index]; }
+
+	// largest peak of all the arenas.
+	std::size_t peak() const;
+
+  private:
+	std::vector<std::unique_ptr<LinearArena>> arenas;
+	unsigned int index = 0;
+};
+
+// std allocator handing out arena memory, deallocate is a no-op. containers
+// using it have to be gone before the arena is reset.
+template <typename T> class ArenaAllocator
+{
+  public:
+	using value_type = T;
+
+	explicit ArenaAllocator(LinearArena &arena) : arena(&arena) {}
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena)
+	{
+	}
+
+	T *allocate(std::size_t count) { return arena->allocateArray<T>(count); }
+	void deallocate(T *, std::size_t) {}
+
+	template <typename U> bool operator==(const ArenaAllocator<U> &other) const
+	{
+		return arena == other.arena;
+	}
+	template <typename U> bool operator!=(const ArenaAllocator<U> &other) const
+	{
+		return arena != other.arena;
+	}
+
+  private:
+	template <typename U> friend class ArenaAllocator;
+
+	LinearArena *arena;
+};
+
+template <typename T> using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// fixed size objects carved out of blocks of `BlockSize`, freed objects are
+// reused before a new block is allocated. not thread safe.
+template <typename T, std::size_t BlockSize = 256> class Pool final
+{
+  public:
+	Pool() = default;
+	Pool(const Pool &) = delete;
+	Pool &operator=(const Pool &) = delete;
+
+	~Pool()
+	{
+		// objects still alive are not destroyed, only their memory freed.
+		for (Slot *block : blocks)
+			::operator delete(block, std::align_val_t(alignof(Slot)));
+	}
+
+	template <typename... Args> T *create(Args &&...args)
+	{
+		if (freeSlots == nullptr)
+			grow();
+		Slot *slot = freeSlots;
+		freeSlots = slot->next;
+		live++;
+		return new (slot->storage) T(std::forward<Args>(args)...);
+	}
+
+	void destroy(T *object)
+	{
+		object->~T();
+		Slot *slot = reinterpret_cast<Slot *>(object);
+		slot->next = freeSlots;
+		freeSlots = slot;
+		live--;
+	}
+
+	std::size_t size() const { return live; }
+	std::size_t capacity() const { return blocks.size() * BlockSize; }
+
+  private:
+	union Slot
+	{
+		Slot *next;
+		alignas(T) unsigned char storage[sizeof(T)];
+	};
+
+	void grow()
+	{
+		Slot *block = static_cast<Slot *>(::operator new(
+			BlockSize * sizeof(Slot), std::align_val_t(alignof(Slot))));
+		blocks.push_back(block);
+		for (std::size_t i = 0; i < BlockSize; i++)
+			block[i].next = i + 1 < BlockSize ? &block[i + 1] : freeSlots;
+		freeSlots = block;
+	}
+
+	Slot *freeSlots = nullptr;
+	std::vector<Slot *> blocks;
+	std::size_t live = 0;
+};
+
+#endif // ALLOCATORS_H
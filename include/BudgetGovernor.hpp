@@ -0,0 +1,83 @@
+#ifndef BUDGET_GOVERNOR_H
+#define BUDGET_GOVERNOR_H
+
+#include <cstdint>
+
+// limits for one frame, 0 = no limit. no quality level changes the draw
+// calls or triangles of a scene, those two are only reported when over.
+struct FrameBudget
+{
+	uint64_t drawCalls = 0;
+	uint64_t triangles = 0;
+	uint64_t uploadBytes = 0;
+	double cpuMs = 0.0;
+	double gpuMs = 0.0;
+
+	bool enabled() const
+	{
+		return drawCalls != 0 || triangles != 0 || uploadBytes != 0 ||
+			   cpuMs > 0.0 || gpuMs > 0.0;
+	}
+};
+
+// what one frame actually cost, same units as FrameBudget.
+struct FrameCost
+{
+	uint64_t drawCalls = 0;
+	uint64_t triangles = 0;
+	uint64_t uploadBytes = 0;
+	double cpuMs = 0.0;
+	double gpuMs = 0.0;
+};
+
+// the knobs the governor turns, from full quality down.
+struct QualityLevel
+{
+	float lodBias;				// texture mip bias, cheaper sampling.
+	float maxRenderScale;		// caps the dynamic resolution scale, skipped
+								// when dynamic resolution is off.
+	unsigned int updateInterval; // frames between animation updates, which
+								 // also defers the instance uploads.
+};
+
+// keeps the frame inside its budget: after a few frames over the upload,
+// cpu or gpu limit it steps down one quality level, after a long stretch
+// with headroom on all of them it steps back up. every change is followed by a
+// cooldown so a level gets measured before the next decision.
+class BudgetGovernor final
+{
+  public:
+	static constexpr unsigned int overFrames = 5;	 // before stepping down.
+	static constexpr unsigned int underFrames = 120; // before stepping up.
+	static constexpr unsigned int settleFrames = 30; // after a change.
+	static constexpr double headroom = 0.7;			 // of every budget.
+
+	// `renderScale` = the dynamic resolution is on, so maxRenderScale has
+	// an effect.
+	BudgetGovernor(const FrameBudget &budget, bool renderScale);
+
+	// feeds the cost of one frame, returns true when the level changed.
+	bool update(const FrameCost &cost);
+
+	const FrameBudget &budget() const { return limits; }
+	unsigned int level() const { return current; }
+	unsigned int levelCount() const;
+	const QualityLevel &quality() const;
+
+  private:
+	// name of the first budget a quality level can reduce that `cost`
+	// exceeds by `factor`, null if none.
+	const char *exceeded(const FrameCost &cost, double factor) const;
+	void logLevel(const char *change) const;
+
+	FrameBudget limits;
+	bool renderScale;
+	unsigned int current = 0;
+	unsigned int over = 0;	// consecutive frames above a budget.
+	unsigned int under = 0; // consecutive frames with headroom.
+	unsigned int cooldown = 0;
+	bool exhausted = false; // warned that the lowest level is not enough.
+	bool unreducible = false; // warned about the draw or triangle budget.
+};
+
+#endif // BUDGET_GOVERNOR_H
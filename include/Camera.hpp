@@ -0,0 +1,68 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+#include <glm/glm.hpp>
+
+#include "Ecs.hpp"
+#include "Input.hpp"
+
+// fly camera components and the systems driving them from the drained input.
+
+struct Camera
+{
+	glm::vec3 position;
+	glm::vec3 front;
+	glm::vec3 up;
+	float yaw;	 // degrees, -90 looks down -z.
+	float pitch; // degrees.
+	float fov;	 // vertical, degrees.
+};
+
+// moves the camera with WASD, `speed` in units per second.
+struct KeyboardMotion
+{
+	float speed;
+};
+
+// turns the camera with the mouse.
+struct MouseLook
+{
+	float sensitivity;
+	float lastX, lastY;
+	bool firstMouse;
+};
+
+// the tutorial camera: at (0, 0, 3) looking down -z, mouse centered in a
+// `width` x `height` window.
+Entity
+spawnCamera(World &world, float width, float height);
+
+glm::mat4
+cameraView(const Camera &camera);
+
+// WASD as x = right, z = forward, zero when no key is held.
+glm::vec3
+keyboardDirection(const InputState &input);
+// between two states of the same camera, `alpha` in [0, 1].
+Camera
+interpolateCamera(const Camera &from, const Camera &to, float alpha);
+
+void
+moveCameras(World &world, const glm::vec3 &direction, float deltaTime);
+void
+lookCameras(World &world, double x, double y);
+void
+zoomCameras(World &world, double offset);
+
+// `camera` turned towards a cursor position newer than the one `look` last
+// saw, for late latching on the render thread. the simulation applies the
+// same position later and arrives at the same orientation. unchanged when
+// the cursor has not moved since the snapshot of `look`.
+Camera
+latchCamera(Camera camera, MouseLook look, double x, double y);
+
+#endif // CAMERA_H
@@ -0,0 +1,105 @@
+#ifndef DYNAMIC_RESOLUTION_H
+#define DYNAMIC_RESOLUTION_H
+
+#include <glad/glad.h>
+
+#include "FrameSync.hpp"
+#include "GpuTimer.hpp"
+#include "Shader.hpp"
+
+#include <memory>
+
+// how the scaled scene reaches the window.
+enum class UpscaleMode
+{
+	Native,	  // no scaling, the scene renders straight into the window.
+	Bilinear, // glBlitFramebuffer with linear filtering.
+	Sharpen,  // bilinear plus an unsharp mask, see upscale.frag.
+};
+
+const char *
+upscaleModeName(UpscaleMode mode);
+bool
+parseUpscaleMode(const char *name, UpscaleMode &mode);
+
+struct DynamicResolutionSettings
+{
+	UpscaleMode upscale = UpscaleMode::Native;
+	double budgetMs = 0.0; // gpu time per frame, 0 = from the frame limit.
+	float minScale = 0.5f; // of the window size, per axis.
+	float sharpness = 0.5f;
+};
+
+// picks the render scale from measured gpu times. the cost of a frame grows
+// with the pixel count, so an overrun scales straight down to the size that
+// fits the budget; growing back happens in small steps, and only after the
+// frames stayed well below the budget for a while. between the two
+// thresholds nothing changes, so the scale does not oscillate.
+class ResolutionController final
+{
+  public:
+	ResolutionController(double budgetMs, float minScale);
+
+	// feeds the gpu time of one frame, returns true when the scale changed.
+	bool update(double gpuMs);
+	// caps the scale, used by the budget governor.
+	void setMaxScale(float scale);
+
+	float scale() const { return current; }
+	double budget() const { return budgetMs; }
+
+  private:
+	double budgetMs;
+	float minScale;
+	float maxScale = 1.0f;
+	float current = 1.0f;
+	double smoothedMs = 0.0;
+	unsigned int overBudget = 0;  // consecutive frames above the budget.
+	unsigned int underBudget = 0; // consecutive frames well below it.
+	unsigned int cooldown = 0;	  // frames before the next change.
+};
+
+// renders the scene into an offscreen framebuffer at a scale of the window
+// size and upscales it into the window. the framebuffer is allocated at the
+// full window size, scaling only shrinks the viewport.
+class DynamicResolution final
+{
+  public:
+	// `upscale` is the source of upscale.vert / upscale.frag, only
+	// UpscaleMode::Sharpen compiles it.
+	DynamicResolution(const DynamicResolutionSettings &settings,
+					  const FrameSync &frames, const ShaderSource &upscale);
+	~DynamicResolution();
+
+	DynamicResolution(const DynamicResolution &) = delete;
+	DynamicResolution &operator=(const DynamicResolution &) = delete;
+
+	// binds the target of the scene and sets the viewport. `width` x `height`
+	// is the window framebuffer size.
+	void beginScene(int width, int height);
+	// upscales the scene into the window framebuffer.
+	void endScene();
+
+	float scale() const { return controller.scale(); }
+	void setMaxScale(float scale) { controller.setMaxScale(scale); }
+	double lastGpuMs() const { return gpuMs; }
+
+  private:
+	void allocate(int width, int height);
+
+	DynamicResolutionSettings settings;
+	ResolutionController controller;
+	GpuTimer timer;
+	double gpuMs = 0.0;
+
+	int windowWidth = 0, windowHeight = 0;
+	int sceneWidth = 0, sceneHeight = 0;
+	GLuint framebuffer = 0, color = 0, depth = 0;
+
+	// the sharpen pass.
+	std::unique_ptr<Shader> upscaleShader;
+	GLuint emptyVAO = 0;
+	GLint scaleLocation, texelLocation;
+};
+
+#endif // DYNAMIC_RESOLUTION_H
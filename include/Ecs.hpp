@@ -0,0 +1,263 @@
+#ifndef ECS_H
+#define ECS_H
+
+#include "JobSystem.hpp"
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// archetype based entity component system. entities with the same set of
+// components share an archetype, which stores them in fixed size chunks with
+// one array per component (SoA). iteration walks those arrays linearly, and
+// adding or removing components moves an entity between archetypes by
+// copying its row, chunks are recycled, so neither allocates per entity.
+
+constexpr unsigned int maxComponents = 64;
+
+using ComponentId = unsigned int;
+using ComponentMask = std::bitset<maxComponents>;
+
+struct ComponentInfo
+{
+	std::size_t size;
+	std::size_t align;
+};
+
+// ids are handed out on first use, in no particular order.
+ComponentId
+registerComponent(std::size_t size, std::size_t align);
+const ComponentInfo &
+componentInfo(ComponentId id);
+
+// components are plain data, rows are moved with memcpy.
+template <typename T>
+ComponentId
+componentId()
+{
+	static_assert(std::is_trivially_copyable_v<T> &&
+					  std::is_trivially_destructible_v<T>,
+				  "components have to be plain data");
+	static const ComponentId id = registerComponent(sizeof(T), alignof(T));
+	return id;
+}
+
+struct Entity
+{
+	uint32_t index = ~0u;
+	uint32_t generation = 0;
+
+	bool operator==(const Entity &other) const
+	{
+		return index == other.index && generation == other.generation;
+	}
+	bool operator!=(const Entity &other) const { return !(*this == other); }
+};
+
+struct Chunk
+{
+	unsigned char *data;
+	uint32_t count;
+};
+
+class Archetype final
+{
+  public:
+	explicit Archetype(const ComponentMask &mask);
+
+	ComponentMask mask;
+	std::vector<ComponentId> components;
+	std::vector<std::size_t> offsets; // of every column inside a chunk.
+	uint32_t capacity;				  // entities per chunk.
+	std::vector<Chunk> chunks;		  // only the last one is not full.
+
+	// archetypes one component away, filled as entities move.
+	std::unordered_map<ComponentId, Archetype *> addEdges;
+	std::unordered_map<ComponentId, Archetype *> removeEdges;
+
+	int column(ComponentId id) const { return columns[id]; }
+
+	Entity *entities(const Chunk &chunk) const
+	{
+		return reinterpret_cast<Entity *>(chunk.data);
+	}
+	template <typename T> T *array(const Chunk &chunk) const
+	{
+		return reinterpret_cast<T *>(chunk.data +
+									 offsets[columns[componentId<T>()]]);
+	}
+	void *component(const Chunk &chunk, int column, uint32_t row) const
+	{
+		return chunk.data + offsets[column] +
+			   row * componentInfo(components[column]).size;
+	}
+
+  private:
+	int8_t columns[maxComponents]; // column of every component, -1 if none.
+};
+
+class World final
+{
+  public:
+	static constexpr std::size_t chunkSize = 16 * 1024;
+
+	World();
+	~World();
+
+	World(const World &) = delete;
+	World &operator=(const World &) = delete;
+
+	template <typename... C> Entity create(const C &...components)
+	{
+		ComponentMask mask;
+		(mask.set(componentId<C>()), ...);
+		Record &record = insert(findArchetype(mask), allocateEntity());
+		(std::memcpy(componentAt(record, componentId<C>()), &components,
+					 sizeof(C)),
+		 ...);
+		return entityOf(record);
+	}
+
+	void destroy(Entity entity);
+	bool alive(Entity entity) const;
+
+	// a no-op for dead entities, like destroy(): the record may belong to
+	// a new entity by now.
+	template <typename T> void add(Entity entity, const T &value = T())
+	{
+		if (!alive(entity))
+			return;
+		ComponentId id = componentId<T>();
+		if (!has(entity, id))
+			move(entity, id, true);
+		std::memcpy(componentAt(records[entity.index], id), &value,
+					sizeof(T));
+	}
+
+	template <typename T> void remove(Entity entity)
+	{
+		ComponentId id = componentId<T>();
+		if (has(entity, id))
+			move(entity, id, false);
+	}
+
+	template <typename T> bool has(Entity entity) const
+	{
+		return has(entity, componentId<T>());
+	}
+
+	// null when the entity is dead or lacks the component. the pointer is
+	// valid until the next structural change.
+	template <typename T> T *get(Entity entity)
+	{
+		ComponentId id = componentId<T>();
+		if (!has(entity, id))
+			return nullptr;
+		return static_cast<T *>(componentAt(records[entity.index], id));
+	}
+
+	// f(count, entities, C *...) for every chunk having all of C. no
+	// entities may be created or destroyed while iterating.
+	template <typename... C, typename F> void eachChunk(F &&function)
+	{
+		ComponentMask required = maskOf<C...>();
+		for (const std::unique_ptr<Archetype> &archetype : archetypes)
+		{
+			if ((archetype->mask & required) != required)
+				continue;
+			for (const Chunk &chunk : archetype->chunks)
+				function(static_cast<std::size_t>(chunk.count),
+						 archetype->entities(chunk),
+						 archetype->template array<C>(chunk)...);
+		}
+	}
+
+	// f(entity, C &...) for every entity having all of C.
+	template <typename... C, typename F> void each(F &&function)
+	{
+		eachChunk<C...>(
+			[&function](std::size_t count, const Entity *entities,
+						C *...arrays)
+			{
+				for (std::size_t i = 0; i < count; i++)
+					function(entities[i], arrays[i]...);
+			});
+	}
+
+	// like each(), the chunks are spread over the job threads.
+	template <typename... C, typename F>
+	void parallelEach(JobSystem &jobs, const F &function)
+	{
+		ComponentMask required = maskOf<C...>();
+		parallelChunks.clear();
+		for (const std::unique_ptr<Archetype> &archetype : archetypes)
+			if ((archetype->mask & required) == required)
+				for (const Chunk &chunk : archetype->chunks)
+					parallelChunks.emplace_back(archetype.get(), &chunk);
+
+		jobs.parallelFor(
+			0, parallelChunks.size(), 1,
+			[this, &function](std::size_t first, std::size_t last)
+			{
+				for (std::size_t c = first; c < last; c++)
+				{
+					const Archetype *archetype = parallelChunks[c].first;
+					const Chunk &chunk = *parallelChunks[c].second;
+					const Entity *entities = archetype->entities(chunk);
+					std::tuple<C *...> arrays(
+						archetype->template array<C>(chunk)...);
+					for (uint32_t i = 0; i < chunk.count; i++)
+						function(entities[i], std::get<C *>(arrays)[i]...);
+				}
+			});
+	}
+
+	std::size_t entityCount() const { return liveEntities; }
+	std::size_t archetypeCount() const { return archetypes.size(); }
+	std::size_t chunkCount() const;
+
+  private:
+	struct Record
+	{
+		Archetype *archetype;
+		uint32_t chunk;
+		uint32_t row;
+		uint32_t generation;
+	};
+
+	template <typename... C> static ComponentMask maskOf()
+	{
+		ComponentMask mask;
+		(mask.set(componentId<C>()), ...);
+		return mask;
+	}
+
+	bool has(Entity entity, ComponentId id) const;
+	Entity entityOf(const Record &record) const;
+	void *componentAt(const Record &record, ComponentId id) const;
+
+	uint32_t allocateEntity();
+	Archetype *findArchetype(const ComponentMask &mask);
+	// appends a row for entity `index` and points its record at it.
+	Record &insert(Archetype *archetype, uint32_t index);
+	// fills the hole with the last row and returns empty chunks to the pool.
+	void erase(Archetype *archetype, uint32_t chunk, uint32_t row);
+	void move(Entity entity, ComponentId id, bool adding);
+
+	std::vector<std::unique_ptr<Archetype>> archetypes;
+	std::unordered_map<ComponentMask, Archetype *> archetypeByMask;
+	std::vector<Record> records;
+	std::vector<uint32_t> freeIndices;
+	std::vector<unsigned char *> freeChunks;
+	std::size_t liveEntities = 0;
+	std::vector<std::pair<const Archetype *, const Chunk *>> parallelChunks;
+};
+
+#endif // ECS_H
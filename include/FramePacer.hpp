@@ -0,0 +1,85 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// how buffer swaps wait for the display.
+enum class VsyncMode
+{
+	Off,
+	On,
+	// swaps late frames right away instead of waiting a whole refresh,
+	// needs EXT_swap_control_tear, falls back to On.
+	Adaptive,
+};
+
+const char *
+vsyncModeName(VsyncMode mode);
+bool
+parseVsyncMode(const char *name, VsyncMode &mode);
+
+struct FramePacingSettings
+{
+	VsyncMode vsync = VsyncMode::On;
+	double targetRate = 0.0;	  // frames per second, 0 = no limit.
+	unsigned int reportEvery = 0; // frames between reports, 0 = at exit.
+};
+
+// frame to frame intervals over the recorded history, in milliseconds.
+struct FramePacingStats
+{
+	unsigned int frames = 0;
+	double mean = 0.0;
+	double stddev = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+	double p99 = 0.0;
+	// intervals longer than 1.5 target periods, or 1.5 means without one.
+	unsigned int late = 0;
+};
+
+// presents frames at a steady rate: sets the swap interval and, with a
+// target rate, sleeps until the next frame is due instead of spinning on
+// the swap. the bulk of the wait is a sleep, the last stretch a spin, so the
+// frame starts on time despite the coarse sleep granularity.
+class FramePacer final
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::size_t historySize = 1024;
+
+	// sets the swap interval of the current context. without a target
+	// rate the swap alone sets the pace.
+	explicit FramePacer(const FramePacingSettings &settings);
+
+	// call at the start of a frame, returns once it is due.
+	void waitForNextFrame();
+	// call after the swap, records the interval since the previous one.
+	void frameDone();
+	// call after the loop idled, the gap is not counted as a frame.
+	void resume();
+
+	const FramePacingSettings &settings() const { return pacing; }
+
+	FramePacingStats stats() const;
+	void report() const;
+
+  private:
+	FramePacingSettings pacing;
+	Clock::duration period{0};
+	Clock::time_point deadline;
+	// how long before the deadline the sleep ends, follows the oversleep.
+	Clock::duration spinMargin = std::chrono::milliseconds(1);
+
+	Clock::time_point lastSwap;
+	bool swapped = false;
+	std::vector<float> intervals; // ring buffer of the last frames.
+	std::size_t next = 0;
+	uint64_t frames = 0;
+	mutable std::vector<float> sorted;
+};
+
+#endif // FRAME_PACER_H
@@ -0,0 +1,50 @@
+#ifndef FRAME_SYNC_H
+#define FRAME_SYNC_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+// bounds how far the cpu runs ahead of the gpu. every frame ends with a
+// fence, and a frame only begins once the fence of the frame that used its
+// slot `framesInFlight` frames ago has signaled. per frame data (streaming
+// buffers, readbacks) keyed on frameIndex() can then be overwritten without
+// synchronizing with the driver. needs a current GL context.
+class FrameSync final
+{
+  public:
+	static constexpr unsigned int maxFramesInFlight = 4;
+
+	explicit FrameSync(unsigned int framesInFlight = 2);
+	~FrameSync();
+
+	FrameSync(const FrameSync &) = delete;
+	FrameSync &operator=(const FrameSync &) = delete;
+
+	// waits for the gpu to release the slot of the next frame.
+	void beginFrame();
+	// fences the commands of the frame, call after its last draw call.
+	void endFrame();
+
+	unsigned int framesInFlight() const { return frames; }
+	// slot of the current frame, in [0, framesInFlight()).
+	unsigned int frameIndex() const { return index; }
+	uint64_t frameNumber() const { return number; }
+
+	// cpu time blocked in the last beginFrame().
+	double lastWaitMs() const { return lastWait; }
+	void report() const;
+
+  private:
+	unsigned int frames;
+	unsigned int index = 0;
+	uint64_t number = 0;
+	GLsync fences[maxFramesInFlight] = {};
+
+	double lastWait = 0.0;
+	double totalWait = 0.0;
+	double maxWait = 0.0;
+	uint64_t waitedFrames = 0; // frames that had to block at all.
+};
+
+#endif // FRAME_SYNC_H
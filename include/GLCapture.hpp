@@ -0,0 +1,24 @@
+#ifndef GL_CAPTURE_H
+#define GL_CAPTURE_H
+
+// records every GL call, with its buffer / texture payloads, into a trace
+// file the OpenGL_Tutorial_replay tool re-issues. the calls are intercepted
+// by the GL instrumentation hooks, so this needs a build configured with
+// OPENGL_TUTORIAL_GL_INSTRUMENT. start it before any GL object is created,
+// the replay has to create them too.
+
+// returns false when the file cannot be opened or the hooks are missing.
+bool
+startGLCapture(const char *path, unsigned int frames);
+
+// marks the end of a frame, stops the capture after the requested count.
+void
+endGLCaptureFrame();
+
+void
+stopGLCapture();
+
+bool
+glCaptureActive();
+
+#endif // GL_CAPTURE_H
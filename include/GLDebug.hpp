@@ -0,0 +1,73 @@
+#ifndef GL_DEBUG_H
+#define GL_DEBUG_H
+
+#include <glad/glad.h>
+
+#include <cstdint>
+
+// driver messages through KHR_debug (core in 4.3): errors, undefined
+// behavior and performance warnings such as buffer stalls or shader
+// recompiles. needs a context created with createWindow(..., debug = true),
+// the callback is only installed when the context actually has the debug
+// flag and the entry points, which a 4.1 context only has through the
+// extension.
+
+enum class GLDebugSeverity
+{
+	Notification,
+	Low,
+	Medium,
+	High,
+};
+
+const char *
+glDebugSeverityName(GLDebugSeverity severity);
+bool
+parseGLDebugSeverity(const char *name, GLDebugSeverity &severity);
+
+struct GLDebugSettings
+{
+	bool enabled = false;
+	// less severe messages are counted but not logged.
+	GLDebugSeverity logSeverity = GLDebugSeverity::Low;
+	// times the same message is logged per second before it is only
+	// counted. the suppressed count is logged when the second is over.
+	unsigned int repeats = 5;
+};
+
+// message counts of the last completed frame.
+struct GLDebugFrameStats
+{
+	uint32_t messages = 0;
+	uint32_t performance = 0; // GL_DEBUG_TYPE_PERFORMANCE
+	uint32_t errors = 0;	  // GL_DEBUG_TYPE_ERROR
+};
+
+// call with the context current, right after createWindow(). messages are
+// delivered synchronously on the GL thread, so they land in the frame of
+// the call that caused them. returns false when the context has no debug
+// output.
+bool
+installGLDebug(const GLDebugSettings &settings);
+
+bool
+glDebugInstalled();
+
+// closes the counters of the current frame, call once per swap. also
+// closes the rate limit window once a second is over.
+void
+endGLDebugFrame();
+
+const GLDebugFrameStats &
+lastFrameGLDebugStats();
+
+// totals by type, and how many messages the rate limit kept from the log.
+void
+reportGLDebug();
+
+// names `name` of `identifier` (GL_BUFFER, GL_TEXTURE, GL_PROGRAM, ...) in
+// debug messages and graphics debuggers. a no-op without KHR_debug.
+void
+labelGLObject(GLenum identifier, GLuint name, const char *label);
+
+#endif // GL_DEBUG_H
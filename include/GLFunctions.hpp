@@ -0,0 +1,15 @@
+#ifndef GL_FUNCTIONS_H
+#define GL_FUNCTIONS_H
+
+// a dense id for every GL entry point glad knows about, in glad.h order.
+enum GLFunctionId : unsigned int
+{
+#define GLAD_FUNCTION(name) id_##name,
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+	glFunctionCount
+};
+
+extern const char *const glFunctionNames[glFunctionCount];
+
+#endif // GL_FUNCTIONS_H
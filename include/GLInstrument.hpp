@@ -0,0 +1,54 @@
+#ifndef GL_INSTRUMENT_H
+#define GL_INSTRUMENT_H
+
+#include <cstdint>
+#include <vector>
+
+// wraps every loaded glad_gl* pointer with a hook that counts the calls (and
+// optionally times them) per frame. only available when the project is
+// configured with OPENGL_TUTORIAL_GL_INSTRUMENT, which defines GLAD_INSTRUMENT.
+
+struct GLInstrumentSettings
+{
+	bool timeCalls = false;		  // measure the cpu time spent in the driver.
+	unsigned int reportEvery = 0; // frames between reports, 0 = never.
+	unsigned int topN = 10;
+};
+
+enum class GLCallOrder
+{
+	Calls,
+	Time,
+};
+
+struct GLCallStat
+{
+	const char *name;
+	double callsPerFrame;
+	double msPerFrame;
+};
+
+// call after gladLoadGLLoader, with the context current. returns false when
+// the instrumentation is not compiled in.
+bool
+installGLInstrumentation(const GLInstrumentSettings &settings);
+
+bool
+glInstrumentationInstalled();
+
+// closes the counters of the current frame, call once per swap.
+void
+endGLInstrumentationFrame();
+
+// per frame averages over every frame since the installation.
+std::vector<GLCallStat>
+topGLCalls(unsigned int count, GLCallOrder order);
+
+// number of GL calls made in the last completed frame.
+uint64_t
+lastFrameGLCalls();
+
+void
+reportGLInstrumentation();
+
+#endif // GL_INSTRUMENT_H
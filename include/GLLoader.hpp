@@ -0,0 +1,43 @@
+#ifndef GL_LOADER_H
+#define GL_LOADER_H
+
+#include <glad/glad.h>
+
+#include "GLFunctions.hpp"
+
+// how the glad_gl* pointers get filled.
+enum class GLLoadMode
+{
+	// gladLoadGLLoader: every core entry point up to the context version,
+	// then the extension list.
+	Full,
+	// every pointer of the context's core version starts out as a
+	// trampoline that looks its function up on the first call and then
+	// replaces itself, so startup only pays for the functions the program
+	// uses. newer functions stay null like in a full load, extensions load
+	// them explicitly. the extension list is never parsed, the
+	// GLAD_GL_VERSION_* flags are set from GL_VERSION.
+	Lazy,
+};
+
+const char *
+glLoadModeName(GLLoadMode mode);
+bool
+parseGLLoadMode(const char *name, GLLoadMode &mode);
+
+// loads the GL functions of the current context through `load`. returns
+// false when no context is current.
+bool
+loadGL(GLLoadMode mode, GLADloadproc load);
+
+// true when the entry point is in the context version or was loaded from
+// an extension. use this instead of testing the glad pointer, which is a
+// trampoline in lazy mode.
+bool
+glFunctionAvailable(GLFunctionId id);
+
+// entry points resolved so far, all of them after a full load.
+unsigned int
+resolvedGLFunctionCount();
+
+#endif // GL_LOADER_H
@@ -0,0 +1,345 @@
+#ifndef GL_TRACE_H
+#define GL_TRACE_H
+
+#include <glad/glad.h>
+
+#include "GLFunctions.hpp"
+#include "TrackedAllocator.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// binary GL command stream, written by the capture hooks (GLCapture.cpp) and
+// re-issued by the replayer. layout, all little endian:
+//
+//   header  "GLTR", u32 version, u32 n, n x (u16 length, name bytes)
+//   record  u16 function index into the header names, the encoded
+//           arguments, then the recorded outputs and return value
+//   special u16 glTraceFrameEnd, or u16 glTraceMapWrite followed by the
+//           target and the bytes written to a mapped buffer before unmap
+//
+// arithmetic arguments are stored raw. const pointers are stored as data
+// when their size is known (glBufferData, glTexImage2D, uniforms, strings,
+// ...), otherwise as the pointer value, which is right for buffer offsets.
+// object names are not remapped: a fresh context hands out the same names
+// in the same order, and the replayer warns when they differ.
+
+constexpr uint32_t glTraceVersion = 1;
+constexpr uint16_t glTraceFrameEnd = 0xffff;
+constexpr uint16_t glTraceMapWrite = 0xfffe;
+
+// trace bytes waiting to be written, or read back for replay.
+using GLTraceBytes =
+	std::vector<unsigned char, TrackedStdAllocator<unsigned char>>;
+
+enum GLTracePointer : uint8_t
+{
+	GLTraceNull,
+	GLTraceValue,
+	GLTraceData,
+};
+
+class GLTraceWriter final
+{
+  public:
+	~GLTraceWriter();
+
+	bool open(const char *path);
+	void close();
+
+	void write(const void *data, std::size_t size);
+	template <typename T> void write(const T &value)
+	{
+		write(&value, sizeof(T));
+	}
+	void writeBlob(const void *data, uint32_t size);
+
+	uint64_t bytesWritten() const { return bytes; }
+
+	// state the pixel payload sizes depend on.
+	GLint unpackAlignment = 4;
+	GLint unpackRowLength = 0;
+	GLint unpackImageHeight = 0;
+	bool pixelUnpackBuffer = false;
+
+	// buffers mapped for writing, copied into the trace on unmap.
+	struct Mapping
+	{
+		void *pointer;
+		GLsizeiptr length;
+	};
+	std::unordered_map<GLenum, Mapping> mappings;
+
+	// functions that already warned about an unknown pointer size.
+	std::vector<bool> warned;
+
+  private:
+	FILE *file = nullptr;
+	GLTraceBytes buffer{TrackedStdAllocator<unsigned char>(
+		trackedAllocator("gl-trace"))};
+	uint64_t bytes = 0;
+};
+
+class GLTraceReader final
+{
+  public:
+	bool open(const char *path);
+
+	template <typename T> T read()
+	{
+		T value{};
+		if (position + sizeof(T) <= data.size())
+			std::memcpy(&value, data.data() + position, sizeof(T));
+		position += sizeof(T);
+		return value;
+	}
+	const unsigned char *readBlob(uint32_t &size);
+
+	bool atEnd() const { return position >= data.size(); }
+	bool failed() const { return position > data.size(); }
+	std::size_t tell() const { return position; }
+	void seek(std::size_t to) { position = to; }
+
+  private:
+	GLTraceBytes data{
+		TrackedStdAllocator<unsigned char>(trackedAllocator("gl-trace"))};
+	std::size_t position = 0;
+};
+
+// the capture in progress, null when none. set by GLCapture.cpp.
+extern GLTraceWriter *glCaptureWriter;
+
+// what the replayer keeps between records.
+struct GLReplayState
+{
+	std::unordered_map<uint64_t, GLsync> syncs;
+	std::unordered_map<GLenum, void *> mappings;
+	std::vector<const GLchar *> strings;
+	std::vector<std::vector<unsigned char>> scratch;
+	std::vector<bool> missing;
+	uint64_t mismatches = 0;
+
+	void *scratchFor(unsigned int index);
+};
+
+// -- helpers shared by the capture and replay templates, see GLTrace.cpp ---
+
+// called before the real function, keeps the writer state in sync.
+void
+glTraceBeforeCall(GLTraceWriter &writer, unsigned int id,
+				  const uint64_t *values);
+void
+glTraceAfterCall(GLTraceWriter &writer, unsigned int id,
+				 const uint64_t *values, uint64_t result);
+
+void
+glTraceEncodeInput(GLTraceWriter &writer, unsigned int id, unsigned int index,
+				   const void *pointer, const uint64_t *values);
+void
+glTraceEncodeString(GLTraceWriter &writer, const GLchar *string);
+void
+glTraceEncodeStrings(GLTraceWriter &writer, unsigned int id,
+					 const GLchar *const *strings, const uint64_t *values);
+// number of object names the function writes to its output argument.
+unsigned int
+glTraceOutputNames(unsigned int id, const uint64_t *values,
+				   unsigned int &index);
+
+const void *
+glTraceDecodeInput(GLTraceReader &reader);
+const GLchar *const *
+glTraceDecodeStrings(GLTraceReader &reader, GLReplayState &state);
+void
+glTraceCheckNames(GLTraceReader &reader, GLReplayState &state,
+				  unsigned int id, const void *names, unsigned int count);
+void
+glTraceMissing(GLReplayState &state, unsigned int id);
+void
+glTraceCheckResult(GLReplayState &state, unsigned int id, uint64_t captured,
+				   uint64_t replayed);
+
+// -- per type encoding ------------------------------------------------------
+
+template <typename T>
+uint64_t
+glTraceValue(T value)
+{
+	uint64_t bits = 0;
+	if constexpr (std::is_pointer_v<T>)
+		bits = reinterpret_cast<uintptr_t>(value);
+	else
+		std::memcpy(&bits, &value, sizeof(T) < 8 ? sizeof(T) : 8);
+	return bits;
+}
+
+template <typename T>
+constexpr bool
+isGLStringList()
+{
+	return std::is_same_v<T, const GLchar *const *>;
+}
+
+template <typename T>
+void
+glTraceEncodeArg(GLTraceWriter &writer, unsigned int id, unsigned int index,
+				 T value, const uint64_t *values)
+{
+	if constexpr (std::is_arithmetic_v<T>)
+		writer.write(value);
+	else if constexpr (std::is_same_v<T, GLsync>)
+		writer.write(glTraceValue(value));
+	else if constexpr (std::is_function_v<std::remove_pointer_t<T>>)
+	{
+		// callbacks cannot be replayed.
+	}
+	else if constexpr (isGLStringList<T>())
+		glTraceEncodeStrings(writer, id, value, values);
+	else if constexpr (std::is_same_v<T, const GLchar *>)
+		glTraceEncodeString(writer, value);
+	else if constexpr (std::is_const_v<std::remove_pointer_t<T>>)
+		glTraceEncodeInput(writer, id, index,
+						   reinterpret_cast<const void *>(value), values);
+	// outputs are written after the call.
+}
+
+template <typename T>
+T
+glTraceDecodeArg(GLTraceReader &reader, GLReplayState &state,
+				 unsigned int index)
+{
+	if constexpr (std::is_arithmetic_v<T>)
+		return reader.read<T>();
+	else if constexpr (std::is_same_v<T, GLsync>)
+	{
+		auto found = state.syncs.find(reader.read<uint64_t>());
+		return found == state.syncs.end() ? nullptr : found->second;
+	}
+	else if constexpr (std::is_function_v<std::remove_pointer_t<T>>)
+		return nullptr;
+	else if constexpr (isGLStringList<T>())
+		return glTraceDecodeStrings(reader, state);
+	else if constexpr (std::is_const_v<std::remove_pointer_t<T>>)
+		return reinterpret_cast<T>(glTraceDecodeInput(reader));
+	else
+		return reinterpret_cast<T>(state.scratchFor(index));
+}
+
+// records one call while forwarding it to `real`.
+template <unsigned int Id, typename R, typename... Args>
+R
+glTraceCapture(GLTraceWriter &writer, R(APIENTRYP real)(Args...),
+			   Args... args)
+{
+	const uint64_t values[sizeof...(Args) + 1] = {glTraceValue(args)...};
+	glTraceBeforeCall(writer, Id, values);
+
+	writer.write(static_cast<uint16_t>(Id));
+	unsigned int index = 0;
+	(glTraceEncodeArg(writer, Id, index++, args, values), ...);
+
+	auto finish = [&](uint64_t result)
+	{
+		unsigned int outputIndex = 0;
+		unsigned int names = glTraceOutputNames(Id, values, outputIndex);
+		if (names != 0)
+			writer.writeBlob(reinterpret_cast<const void *>(
+								 static_cast<uintptr_t>(values[outputIndex])),
+							 names * sizeof(GLuint));
+		glTraceAfterCall(writer, Id, values, result);
+	};
+
+	if constexpr (std::is_void_v<R>)
+	{
+		real(args...);
+		finish(0);
+	}
+	else
+	{
+		R result = real(args...);
+		if constexpr (std::is_arithmetic_v<R> || std::is_same_v<R, GLsync>)
+			writer.write(glTraceValue(result));
+		finish(glTraceValue(result));
+		return result;
+	}
+}
+
+// re-issues one recorded call through `*Slot`, the glad function pointer.
+template <unsigned int Id, typename Function, Function *Slot> struct GLReplay;
+
+template <unsigned int Id, typename R, typename... Args,
+		  R(APIENTRYP *Slot)(Args...)>
+struct GLReplay<Id, R(APIENTRYP)(Args...), Slot>
+{
+	static void call(GLTraceReader &reader, GLReplayState &state)
+	{
+		replay(reader, state, std::index_sequence_for<Args...>());
+	}
+
+	template <std::size_t... Index>
+	static void replay(GLTraceReader &reader, GLReplayState &state,
+					   std::index_sequence<Index...>)
+	{
+		// braced init keeps the arguments in the order they were written.
+		std::tuple<Args...> args{
+			glTraceDecodeArg<Args>(reader, state, Index)...};
+		uint64_t values[sizeof...(Args) + 1] = {};
+		std::apply(
+			[&](auto... arg)
+			{
+				unsigned int i = 0;
+				((values[i++] = glTraceValue(arg)), ...);
+			},
+			args);
+
+		// entry points the context does not provide are skipped, the rest
+		// of the record still has to be consumed.
+		bool available = *Slot != nullptr;
+		if (!available)
+			glTraceMissing(state, Id);
+
+		uint64_t replayed = 0;
+		if (!available)
+		{
+			if constexpr (std::is_arithmetic_v<R> || std::is_same_v<R, GLsync>)
+				reader.read<uint64_t>();
+		}
+		else if constexpr (std::is_void_v<R>)
+			std::apply(*Slot, args);
+		else
+		{
+			R result = std::apply(*Slot, args);
+			replayed = glTraceValue(result);
+			if constexpr (std::is_same_v<R, GLsync>)
+				state.syncs[reader.read<uint64_t>()] = result;
+			else if constexpr (std::is_arithmetic_v<R>)
+				glTraceCheckResult(state, Id, reader.read<uint64_t>(),
+								   replayed);
+			else if constexpr (std::is_same_v<R, void *>)
+				state.mappings[static_cast<GLenum>(values[0])] = result;
+		}
+
+		unsigned int outputIndex = 0;
+		unsigned int names = glTraceOutputNames(Id, values, outputIndex);
+		if (names != 0 && !available)
+		{
+			uint32_t size;
+			reader.readBlob(size);
+		}
+		else if (names != 0)
+			glTraceCheckNames(reader, state, Id,
+							  reinterpret_cast<const void *>(
+								  static_cast<uintptr_t>(values[outputIndex])),
+							  names);
+	}
+};
+
+using GLReplayFunction = void (*)(GLTraceReader &, GLReplayState &);
+
+#endif // GL_TRACE_H
@@ -0,0 +1,31 @@
+#ifndef GPU_TIMER_H
+#define GPU_TIMER_H
+
+#include <glad/glad.h>
+
+#include "FrameSync.hpp"
+
+// measures gpu time with GL_TIME_ELAPSED queries, one per frame in flight so
+// reading a result never stalls: by the time a slot comes around again,
+// FrameSync waited for the frame that used it.
+class GpuTimer final
+{
+  public:
+	explicit GpuTimer(const FrameSync &frames);
+	~GpuTimer();
+
+	GpuTimer(const GpuTimer &) = delete;
+	GpuTimer &operator=(const GpuTimer &) = delete;
+
+	// starts timing the current frame. returns the time of the frame that
+	// used this slot before in `previousMs`, when there was one.
+	bool begin(double &previousMs);
+	void end();
+
+  private:
+	const FrameSync &frames;
+	GLuint queries[FrameSync::maxFramesInFlight];
+	bool issued[FrameSync::maxFramesInFlight] = {};
+};
+
+#endif // GPU_TIMER_H
@@ -0,0 +1,112 @@
+#ifndef HITCH_DETECTOR_H
+#define HITCH_DETECTOR_H
+
+#include "JobSystem.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct HitchSettings
+{
+	// a frame longer than factor x the median is a hitch, 0 = off.
+	double factor = 0.0;
+	unsigned int history = 240; // frames kept and written per hitch.
+	std::string directory = ".";
+};
+
+// what the rest of the frame measured, recorded next to the cpu zones.
+struct HitchCounters
+{
+	double gpuMs = 0.0; // the latest gpu timer result, frames behind.
+	uint64_t uploadBytes = 0;
+	uint64_t drawCalls = 0;
+	uint32_t glPerformanceMessages = 0; // KHR_debug performance warnings.
+};
+
+// keeps the last frames in a ring buffer: the cpu time of every phase of
+// the frame, the gpu time, heap allocations and upload bytes. when a frame
+// takes more than `factor` times the median frame time the whole buffer is
+// written as a chrome trace (chrome://tracing, ui.perfetto.dev) to
+// `directory`/hitch-<frame>.json, on a job thread so the write does not
+// cause the next hitch. records are fixed size, recording never allocates.
+class HitchDetector final
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr unsigned int maxZones = 16;
+	// frames needed before the median means anything.
+	static constexpr unsigned int warmupFrames = 30;
+
+	HitchDetector(const HitchSettings &settings, JobSystem &jobs);
+	// waits for a trace still being written.
+	~HitchDetector();
+
+	HitchDetector(const HitchDetector &) = delete;
+	HitchDetector &operator=(const HitchDetector &) = delete;
+
+	bool enabled() const { return settings.factor > 0.0; }
+
+	// ends the current zone and starts `name`, a string literal. the zones
+	// are the consecutive phases of a frame.
+	void zone(const char *name);
+	// call after the swap, the frame time is the swap to swap interval.
+	void endFrame(const HitchCounters &counters);
+	// call after the loop idled, the gap is not a frame.
+	void resume();
+
+	uint64_t hitchCount() const { return hitches; }
+
+  private:
+	struct Zone
+	{
+		const char *name;
+		float startMs, durationMs; // relative to the frame start.
+	};
+
+	struct Record
+	{
+		uint64_t frame;
+		double startMs; // since the detector was created.
+		float frameMs;
+		float gpuMs;
+		uint32_t allocations;
+		uint64_t uploadBytes;
+		uint64_t drawCalls;
+		uint32_t glPerformanceMessages;
+		unsigned int zoneCount;
+		Zone zones[maxZones];
+	};
+
+	float sinceFrameStart(Clock::time_point time) const;
+	void closeZone(Clock::time_point now);
+	float medianFrameMs();
+	void dump(float medianMs);
+	// runs on a job thread, only reads the snapshot.
+	void write(float medianMs);
+
+	HitchSettings settings;
+	JobSystem &jobs;
+	Clock::time_point created;
+	Clock::time_point frameStart;
+	bool started = false;
+	uint64_t allocationsAtStart = 0;
+
+	Record current;
+	std::vector<Record> records; // ring buffer.
+	std::size_t next = 0;
+	uint64_t frames = 0;
+	uint64_t hitches = 0;
+	uint64_t quietUntil = 0; // no second trace for the same spike.
+	std::vector<float> sorted;
+
+	// the trace being written, owned by the job until `writing` clears.
+	std::vector<Record> snapshot;
+	std::atomic<bool> writing{false};
+	JobCounter writes;
+};
+
+#endif // HITCH_DETECTOR_H
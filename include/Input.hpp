@@ -0,0 +1,99 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+#include "SpscQueue.hpp"
+
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+
+// what the glfw callbacks record, consumed by another thread.
+struct InputEvent
+{
+	enum Type : uint8_t
+	{
+		KeyDown,
+		KeyUp,
+		CursorMove,
+		Scroll,
+	};
+
+	Type type;
+	int32_t key; // glfw key code of KeyDown / KeyUp.
+	double x, y; // cursor position, or the scroll offset in y.
+	std::chrono::steady_clock::time_point time; // when the callback ran.
+};
+
+// written by the callbacks on the glfw thread, drained by one consumer.
+class InputQueue final
+{
+  public:
+	static constexpr std::size_t capacity = 1024;
+	// slots only key transitions may use. a dropped key up would leave the
+	// key held, cursor moves and scrolls are dropped first.
+	static constexpr std::size_t keyReserve = 64;
+
+	// callbacks cannot wait, events beyond the capacity are dropped.
+	void push(const InputEvent &event);
+	bool pop(InputEvent &event) { return events.pop(event); }
+
+	uint64_t droppedEvents() const
+	{
+		return dropped.load(std::memory_order_relaxed);
+	}
+
+	// -- producer side, what the glfw thread itself needs to know ----------
+
+	// tells whether events came in.
+	uint64_t pushedEvents() const { return pushed; }
+	// the newest cursor position, false before the first move.
+	bool latestCursor(double &x, double &y) const
+	{
+		x = cursorX;
+		y = cursorY;
+		return cursorKnown;
+	}
+	// times of the oldest and the newest event pushed since the last call,
+	// false when there was none. used to measure input latency.
+	bool takeEventTimes(std::chrono::steady_clock::time_point &first,
+						std::chrono::steady_clock::time_point &last);
+
+  private:
+	SpscQueue<InputEvent, capacity> events;
+	std::atomic<uint64_t> dropped{0};
+
+	uint64_t pushed = 0;
+	bool cursorKnown = false;
+	double cursorX = 0.0, cursorY = 0.0;
+	bool pendingTimes = false;
+	std::chrono::steady_clock::time_point firstTime, lastTime;
+};
+
+// the input as seen by the consumer after draining.
+struct InputState
+{
+	std::bitset<GLFW_KEY_LAST + 1> keys; // held keys.
+	bool cursorMoved = false;
+	double cursorX = 0.0, cursorY = 0.0; // latest position.
+	double scroll = 0.0;				 // offsets since the last drain.
+
+	bool held(int key) const { return keys[key]; }
+};
+
+// registers the key, cursor and scroll callbacks of `window`, which push
+// into `queue` from then on. escape closes the window right away.
+void
+installInputCallbacks(GLFWwindow *window, InputQueue &queue);
+
+// applies every queued event to `state`. cursor moves collapse into the last
+// position and scroll offsets add up; both start over with every drain.
+void
+drainInput(InputQueue &queue, InputState &state);
+
+#endif // INPUT_H
@@ -0,0 +1,223 @@
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class JobSystem;
+class JobPool;
+
+// a unit of work. the callable lives inside the job, so scheduling one never
+// allocates once the pools are warm.
+struct Job
+{
+	static constexpr std::size_t storageSize = 64;
+
+	void (*function)(Job &job) = nullptr;
+	void (*destroy)(Job &job) = nullptr;
+	class JobCounter *counter = nullptr;
+	JobPool *pool = nullptr;
+	Job *next = nullptr; // free list and continuation list link.
+	alignas(std::max_align_t) unsigned char storage[storageSize];
+};
+
+// counts unfinished jobs. waiting on it helps executing jobs, and jobs can
+// be chained to run once it drops to zero (JobSystem::runAfter). wait for a
+// counter before destroying it, done() alone is not enough.
+class JobCounter final
+{
+  public:
+	JobCounter() = default;
+	JobCounter(const JobCounter &) = delete;
+	JobCounter &operator=(const JobCounter &) = delete;
+
+	bool done() const { return pending.load(std::memory_order_acquire) == 0; }
+
+  private:
+	friend class JobSystem;
+
+	std::atomic<int64_t> pending{0};
+	std::mutex continuationLock;
+	Job *continuations = nullptr;
+};
+
+// jobs of one thread. any thread can release a job, only the owner
+// allocates, so released jobs go through a lock free stack.
+class JobPool final
+{
+  public:
+	JobPool() = default;
+	JobPool(const JobPool &) = delete;
+	JobPool &operator=(const JobPool &) = delete;
+
+	Job *allocate();
+	void release(Job *job);
+
+  private:
+	static constexpr std::size_t blockSize = 256;
+
+	Job *freeJobs = nullptr;
+	std::atomic<Job *> releasedJobs{nullptr};
+	std::vector<std::unique_ptr<Job[]>> blocks;
+};
+
+// Chase-Lev deque: the owner pushes and pops at the bottom, other threads
+// steal from the top.
+class JobDeque final
+{
+  public:
+	static constexpr int64_t capacity = 4096;
+
+	// false when full, the caller runs the job itself then.
+	bool push(Job *job);
+	Job *pop();
+	Job *steal();
+
+  private:
+	alignas(64) std::atomic<int64_t> top{0};
+	alignas(64) std::atomic<int64_t> bottom{0};
+	std::atomic<Job *> jobs[capacity];
+};
+
+// work stealing scheduler. every worker, and the thread that created the
+// system, owns a deque and a job pool; idle threads steal from the others.
+// jobs may only be scheduled from those threads, GL calls go through the
+// main thread queue which the render loop drains.
+class JobSystem final
+{
+  public:
+	// 0 workers = one per hardware thread besides the main thread.
+	explicit JobSystem(unsigned int workerCount = 0);
+	~JobSystem();
+
+	JobSystem(const JobSystem &) = delete;
+	JobSystem &operator=(const JobSystem &) = delete;
+
+	unsigned int workerCount() const { return workers.size(); }
+	// main thread + workers.
+	unsigned int threadCount() const { return threads.size(); }
+	// 0 on the main thread, 1.. on the workers, notOwned on any other.
+	static constexpr unsigned int notOwned = ~0u;
+	static unsigned int threadIndex();
+
+	// schedules `function()`, incrementing `counter` until it finished.
+	template <typename F> void run(F &&function, JobCounter *counter = nullptr)
+	{
+		schedule(makeJob(std::forward<F>(function), counter));
+	}
+
+	// schedules `function()` once `dependency` dropped to zero.
+	template <typename F>
+	void runAfter(JobCounter &dependency, F &&function,
+				  JobCounter *counter = nullptr)
+	{
+		scheduleAfter(dependency,
+					  makeJob(std::forward<F>(function), counter));
+	}
+
+	// runs body(first, last) over [begin, end) in chunks of `grain` items
+	// and returns when all of them are done. 0 picks a grain that gives
+	// every thread a few chunks.
+	template <typename F>
+	void parallelFor(std::size_t begin, std::size_t end, std::size_t grain,
+					 const F &body)
+	{
+		if (begin >= end)
+			return;
+		std::size_t count = end - begin;
+		if (grain == 0)
+			grain = std::max<std::size_t>(1, count / (4 * threadCount()));
+		if (count <= grain || workers.empty())
+		{
+			body(begin, end);
+			return;
+		}
+
+		JobCounter counter;
+		for (std::size_t first = begin; first < end; first += grain)
+		{
+			std::size_t last = std::min(end, first + grain);
+			run([&body, first, last]() { body(first, last); }, &counter);
+		}
+		wait(counter);
+	}
+
+	// executes other jobs until `counter` reached zero.
+	void wait(JobCounter &counter);
+
+	// queues `function()` for the next drainMainThread(), callable from any
+	// job. used for everything touching the GL context.
+	template <typename F> void runOnMainThread(F &&function)
+	{
+		Job *job = makeJob(std::forward<F>(function), nullptr);
+		std::lock_guard<std::mutex> lock(mainThreadLock);
+		mainThreadJobs.push_back(job);
+	}
+
+	// runs the queued main thread jobs, call once per frame.
+	void drainMainThread();
+
+  private:
+	struct Thread
+	{
+		JobDeque deque;
+		JobPool pool;
+	};
+
+	template <typename F> Job *makeJob(F &&function, JobCounter *counter)
+	{
+		using Function = std::decay_t<F>;
+		static_assert(sizeof(Function) <= Job::storageSize,
+					  "job captures too much, capture a pointer instead");
+		static_assert(alignof(Function) <= alignof(std::max_align_t),
+					  "job callable is over aligned");
+
+		Job *job = ownThread().pool.allocate();
+		new (job->storage) Function(std::forward<F>(function));
+		job->function = [](Job &job)
+		{ (*std::launder(reinterpret_cast<Function *>(job.storage)))(); };
+		job->destroy = [](Job &job)
+		{ std::launder(reinterpret_cast<Function *>(job.storage))->~Function(); };
+		job->counter = counter;
+		if (counter != nullptr)
+			counter->pending.fetch_add(1, std::memory_order_relaxed);
+		return job;
+	}
+
+	// the deque and pool of the calling thread, aborts on threads the
+	// system does not own: their pushes would race with the owner.
+	Thread &ownThread();
+	void schedule(Job *job);
+	void scheduleAfter(JobCounter &dependency, Job *job);
+	void execute(Job *job);
+	Job *findJob(unsigned int index);
+	void workerMain(unsigned int index);
+
+	std::vector<std::unique_ptr<Thread>> threads;
+	std::vector<std::thread> workers;
+	std::atomic<bool> running{true};
+
+	// workers sleep here when there is nothing to steal. every push bumps
+	// `pushes`, a worker only sleeps while it has not changed since it last
+	// looked for a job.
+	std::mutex sleepLock;
+	std::condition_variable wakeUp;
+	std::atomic<unsigned int> sleeping{0};
+	std::atomic<uint64_t> pushes{0};
+
+	std::mutex mainThreadLock;
+	std::vector<Job *> mainThreadJobs;
+	std::vector<Job *> drainingJobs;
+};
+
+#endif // JOB_SYSTEM_H
@@ -0,0 +1,40 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// input to swap latency: for every frame that consumed input, the time from
+// its oldest and its newest event to the return of glfwSwapBuffers. the
+// display adds its own scanout delay on top, which the cpu cannot see.
+class LatencyStats final
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	static constexpr std::size_t historySize = 4096;
+
+	// `reportEvery` frames with input between reports, 0 = only report().
+	explicit LatencyStats(unsigned int reportEvery);
+
+	// the frame being submitted reflects events from `first` to `last`.
+	void latched(Clock::time_point first, Clock::time_point last);
+	// call after the swap.
+	void presented(Clock::time_point now);
+
+	void report() const;
+
+  private:
+	unsigned int reportEvery;
+	bool pending = false;
+	Clock::time_point first, last;
+
+	// ring buffers of the last frames with input, in milliseconds.
+	std::vector<float> oldest, newest;
+	std::size_t next = 0;
+	uint64_t frames = 0;
+	mutable std::vector<float> sorted;
+};
+
+#endif // LATENCY_H
@@ -0,0 +1,37 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <spdlog/spdlog.h>
+
+#include <cstddef>
+
+// log calls on the frame path only format into a stack buffer and copy it
+// into a queue slot, a worker thread does the console I/O. the slots are
+// allocated up front and keep messages of up to 250 characters inline, so
+// such a message does not allocate. when the queue is full the oldest
+// message is dropped rather than blocking the caller.
+//
+// spdlog::debug and trace are still formatted when disabled at runtime,
+// per frame messages use SPDLOG_DEBUG / SPDLOG_TRACE instead, which
+// compile to nothing below SPDLOG_ACTIVE_LEVEL (OPENGL_TUTORIAL_LOG_LEVEL).
+struct LoggingSettings
+{
+	std::size_t queueSize = 8192; // messages.
+	spdlog::level::level_enum level = spdlog::level::info;
+};
+
+// makes an async console logger the default one for its lifetime. create
+// it before anything logs from another thread and destroy it after those
+// threads are gone: the destructor drains the queue, stops the logging
+// thread and goes back to synchronous logging.
+class AsyncLogging final
+{
+  public:
+	explicit AsyncLogging(const LoggingSettings &settings = LoggingSettings());
+	~AsyncLogging();
+
+	AsyncLogging(const AsyncLogging &) = delete;
+	AsyncLogging &operator=(const AsyncLogging &) = delete;
+};
+
+#endif // LOGGING_H
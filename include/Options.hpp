@@ -0,0 +1,90 @@
+#ifndef OPTIONS_H
+#define OPTIONS_H
+
+#include "BudgetGovernor.hpp"
+#include "DynamicResolution.hpp"
+#include "FramePacer.hpp"
+#include "GLDebug.hpp"
+#include "GLInstrument.hpp"
+#include "GLLoader.hpp"
+#include "HitchDetector.hpp"
+#include "Logging.hpp"
+#include "Redraw.hpp"
+#include "Renderer.hpp"
+#include "SceneGenerator.hpp"
+
+#include <string>
+
+// everything that can be configured from the command line.
+struct Options
+{
+	SceneDesc scene;
+
+	// job system worker threads, 0 = one per spare hardware thread.
+	unsigned int workers = 0;
+	SubmitMode submit = SubmitMode::Instanced;
+	// fixed simulation steps per second, independent of the frame rate.
+	double simulationRate = 60.0;
+
+	// frames the cpu may queue ahead of the gpu, 1 to 4.
+	unsigned int framesInFlight = 2;
+	// render scale driven by the gpu time, off with UpscaleMode::Native.
+	DynamicResolutionSettings resolution;
+	// texture and buffer bytes uploaded per frame, 0 = unlimited.
+	uint64_t uploadBudget = 256 * 1024;
+	// per frame limits, the governor lowers the quality to meet them.
+	FrameBudget budget;
+	// on demand waits for events while the image would not change.
+	RedrawMode redraw = RedrawMode::Continuous;
+	// swap interval, frame limiter and frame time statistics.
+	FramePacingSettings pacing;
+
+	// input to swap latency distributions, reported every N frames with
+	// input and at exit.
+	bool latencyStats = false;
+	unsigned int latencyReportEvery = 0;
+
+	// traces of the last frames, written when one takes too long.
+	HitchSettings hitch;
+
+	// lazy resolves GL functions on their first call instead of at startup.
+	GLLoadMode glLoad = GLLoadMode::Full;
+	// KHR_debug driver messages, needs a debug context.
+	GLDebugSettings glDebug;
+
+	// per frame GL call statistics, needs OPENGL_TUTORIAL_GL_INSTRUMENT.
+	bool glStats = false;
+	GLInstrumentSettings glInstrument;
+
+	// async console logging, the level can only go down to what
+	// OPENGL_TUTORIAL_LOG_LEVEL compiled in for the SPDLOG_* macros.
+	LoggingSettings logging;
+
+	// GL command stream capture for the replay tool, empty path = off.
+	std::string capturePath;
+	unsigned int captureFrames = 60;
+};
+
+enum class ParseResult
+{
+	Run,   // the options are complete.
+	Help,  // --help printed the usage, exit with 0.
+	Error, // an unknown option or a bad value, exit with 2.
+};
+
+// decimal digits only, no sign, in range. shared with the tools.
+bool
+parseUnsigned(const char *text, unsigned long long &value);
+// the whole text has to be a number.
+bool
+parseFloat(const char *text, float &value);
+
+// more workers than hardware threads only add contention, larger requests
+// are lowered to that (with a warning). 0 stays 0, one per spare thread.
+unsigned int
+clampWorkers(unsigned long long workers);
+
+ParseResult
+parseOptions(int argc, char **argv, Options &options);
+
+#endif // OPTIONS_H
@@ -0,0 +1,59 @@
+#ifndef REDRAW_H
+#define REDRAW_H
+
+#include "Simulation.hpp"
+
+#include <chrono>
+#include <cstdint>
+
+enum class RedrawMode
+{
+	Continuous, // a new frame every iteration.
+	OnDemand,	// only when the image would change, blocks in between.
+};
+
+const char *
+redrawModeName(RedrawMode mode);
+bool
+parseRedrawMode(const char *name, RedrawMode &mode);
+
+// decides in on demand mode whether a frame has to be drawn. the image is
+// invalid after invalidate() (resize, expose, edits), while the camera or
+// the scene moves, and for a few simulation steps after any input, until
+// the simulation caught up with it. otherwise the loop waits for events.
+class RedrawTracker final
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	// `settle` seconds of redraws follow every input event and every change.
+	RedrawTracker(RedrawMode mode, double settle);
+
+	void invalidate() { invalid = true; }
+
+	// `inputEvents` is InputQueue::pushedEvents(), `animating` whether the
+	// scene itself moves.
+	bool needsRedraw(const SimulationState &state, uint64_t inputEvents,
+					 bool animating, Clock::time_point now);
+	void drawn(const SimulationState &state);
+
+	// blocks in glfwWaitEventsTimeout until an event arrives, at most
+	// `timeout` seconds.
+	void waitForEvents(double timeout);
+
+	RedrawMode mode() const { return redrawMode; }
+	uint64_t drawnFrames() const { return frames; }
+	uint64_t idleWaits() const { return waits; }
+
+  private:
+	RedrawMode redrawMode;
+	Clock::duration settleTime;
+	Clock::time_point settleUntil;
+	bool invalid = true;
+	uint64_t seenEvents = 0;
+	Camera lastCamera{};
+	uint64_t frames = 0;
+	uint64_t waits = 0;
+};
+
+#endif // REDRAW_H
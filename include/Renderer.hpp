@@ -0,0 +1,126 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "FrameSync.hpp"
+#include "JobSystem.hpp"
+#include "SceneGenerator.hpp"
+#include "Shader.hpp"
+#include "TransformSystem.hpp"
+#include "UploadScheduler.hpp"
+
+class StartupTimeline;
+
+// a range of vertices inside the shared vertex buffer.
+struct Mesh
+{
+	GLint first;
+	GLsizei count;
+};
+
+// how the model matrices reach the shader.
+enum class SubmitMode
+{
+	Uniform,   // one glUniformMatrix4fv and draw call per object.
+	Instanced, // an instance buffer and one draw call per DrawGroup.
+};
+
+const char *
+submitModeName(SubmitMode mode);
+bool
+parseSubmitMode(const char *name, SubmitMode &mode);
+
+// an image decoded to 8 bit RGB, bottom row first.
+struct TextureImage
+{
+	const char *path = nullptr;
+	int width = 0, height = 0; // 0 when the file could not be decoded.
+	UploadBytes pixels{
+		TrackedStdAllocator<unsigned char>(trackedAllocator("uploads"))};
+};
+
+// the files a Renderer is built from. reading and decoding them needs no
+// GL context.
+struct RendererAssets
+{
+	ShaderSource shader;
+	TextureImage textures[2];
+};
+
+// schedules one job per file, `loaded` drops to zero once all of them are
+// in `assets`. the steps are recorded in `timeline` when there is one.
+void
+loadRendererAssets(JobSystem &jobs, RendererAssets &assets, JobCounter &loaded,
+				   StartupTimeline *timeline = nullptr);
+
+// what the last frame submitted.
+struct RenderStats
+{
+	uint64_t drawCalls = 0;
+	uint64_t triangles = 0;
+	uint64_t uploadBytes = 0;
+};
+
+// owns the GL resources needed to draw a generated scene: the shader, the
+// two textures, the mesh buffer and the instance buffer. needs a current GL
+// context and loaded `assets`, the pixels are moved out of them. the
+// vertices are uploaded right away, the texels go through `uploads` and the
+// textures fill in row by row until it processed them. per frame data goes
+// to the slot of frames.frameIndex(), the frames have to be bracketed by
+// frames.beginFrame() / endFrame().
+class Renderer final
+{
+  public:
+	static constexpr unsigned int meshCount = 2;
+	static constexpr unsigned int materialCount = 8;
+
+	Renderer(const Scene &scene, SubmitMode mode, const FrameSync &frames,
+			 UploadScheduler &uploads, RendererAssets &assets);
+
+	~Renderer();
+
+	Renderer(const Renderer &) = delete;
+	Renderer &operator=(const Renderer &) = delete;
+
+	// clears the framebuffer and draws every object with the matrices of
+	// the last transforms.update(). same as prepare() followed by submit().
+	void draw(const glm::mat4 &view, const glm::mat4 &projection,
+			  const TransformSystem &transforms);
+
+	// everything of a frame that does not depend on the camera: clearing,
+	// binding and the instance uploads.
+	void prepare(const TransformSystem &transforms);
+	// writes the camera into this frame's slot of its uniform buffer and
+	// issues the draw calls.
+	// the camera is latched as late as possible, after prepare().
+	void submit(const glm::mat4 &view, const glm::mat4 &projection,
+				const TransformSystem &transforms);
+
+	// far plane distance that keeps the whole scene visible.
+	float farPlane() const;
+
+	// biases the mip level the scene textures are sampled at, positive
+	// values pick smaller mips.
+	void setLodBias(float bias);
+
+	const RenderStats &stats() const { return frameStats; }
+
+  private:
+	void uploadInstances(const TransformSystem &transforms);
+
+	const Scene &scene;
+	SubmitMode mode;
+	const FrameSync &frames;
+	Shader shaderProgram;
+	unsigned int texture0, texture1;
+	unsigned int VAO, VBO;
+	unsigned int instanceVBO = 0;
+	unsigned int cameraUBO;
+	GLsizeiptr cameraSlotSize; // one CameraBlock, padded to the alignment.
+	GLint modelLocation, tintLocation;
+	RenderStats frameStats;
+};
+
+#endif // RENDERER_H
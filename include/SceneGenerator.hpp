@@ -0,0 +1,70 @@
+#ifndef SCENE_GENERATOR_H
+#define SCENE_GENERATOR_H
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// how the generator places objects in the world.
+enum class SceneDistribution
+{
+	Tutorial,  // the 10 hand placed cubes of the original tutorial.
+	Uniform,   // uniformly inside a cube of side 2 * extent.
+	Clustered, // gaussian blobs around a few random centers.
+	Grid,	   // regular 3d lattice.
+	City,	   // blocks of buildings on the ground plane.
+};
+
+struct SceneDesc
+{
+	std::size_t objectCount = 10;
+	SceneDistribution distribution = SceneDistribution::Tutorial;
+	uint32_t seed = 1;
+
+	// half size of the populated volume, 0 picks one from objectCount.
+	float extent = 0.0f;
+	unsigned int clusterCount = 16;
+
+	// objects get mesh / material ids in [0, variety).
+	unsigned int meshVariety = 1;
+	unsigned int materialVariety = 1;
+
+	// fraction of objects that animate every frame.
+	float dynamicRatio = 0.0f;
+};
+
+struct SceneObject
+{
+	glm::vec3 position;
+	float rotationAngle; // degrees around rotationAxis.
+	glm::vec3 rotationAxis;
+	uint16_t mesh;
+	uint16_t material;
+	glm::vec3 scale;
+	uint32_t dynamic; // non zero when the object animates.
+};
+
+struct Scene
+{
+	SceneDesc desc;
+	std::vector<SceneObject> objects;
+	std::size_t dynamicCount = 0;
+	float radius = 0.0f; // bounding radius around the origin.
+};
+
+// the same desc (including the seed) yields the same scene with the same
+// binary, so benchmarks of different render paths are comparable. the
+// random stream (mt19937) is portable, but the placement math goes through
+// libm, which may round differently on other platforms.
+Scene
+generateScene(const SceneDesc &desc);
+
+const char *
+sceneDistributionName(SceneDistribution distribution);
+
+bool
+parseSceneDistribution(const char *name, SceneDistribution &distribution);
+
+#endif // SCENE_GENERATOR_H
@@ -0,0 +1,69 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "JobSystem.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using NodeId = uint32_t;
+constexpr NodeId noParent = ~0u;
+
+struct LocalTransform
+{
+	glm::vec3 position = glm::vec3(0.0f);
+	glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+	glm::vec3 scale = glm::vec3(1.0f);
+};
+
+// transform hierarchy in flat arrays, one array per field, ordered breadth
+// first: every parent comes before its children and each depth level is
+// one contiguous range. a world matrix update is then a single forward
+// pass where a node is dirty if it or its parent was, and the nodes of one
+// level can be updated in parallel.
+class SceneGraph final
+{
+  public:
+	// ids stay valid when the nodes are reordered.
+	NodeId addNode(NodeId parent, const LocalTransform &local);
+
+	LocalTransform local(NodeId node) const;
+	void setLocal(NodeId node, const LocalTransform &local);
+
+	// recomputes the world matrices of the dirty subtrees.
+	void update();
+	// the same, every level split over the job threads.
+	void update(JobSystem &jobs);
+
+	const glm::mat4 &world(NodeId node) const { return worlds[orderOf[node]]; }
+
+	std::size_t nodeCount() const { return nodeOf.size(); }
+	std::size_t levelCount() const { return levelStarts.size() - 1; }
+	// world matrices recomputed by the last update.
+	std::size_t updatedCount() const { return updated; }
+
+  private:
+	// restores the breadth first order after nodes were added.
+	void linearize();
+	std::size_t updateRange(std::size_t first, std::size_t last);
+
+	// indexed by position in the breadth first order.
+	std::vector<uint32_t> parents; // order index, noParent for roots.
+	std::vector<glm::vec3> positions;
+	std::vector<glm::quat> rotations;
+	std::vector<glm::vec3> scales;
+	std::vector<glm::mat4> worlds;
+	std::vector<uint8_t> dirty;
+	std::vector<NodeId> nodeOf;
+
+	std::vector<uint32_t> orderOf;	   // indexed by NodeId.
+	// first order index of every depth, plus the end.
+	std::vector<uint32_t> levelStarts = {0};
+	bool ordered = true;
+	std::size_t updated = 0;
+};
+
+#endif // SCENE_GRAPH_H
@@ -0,0 +1,84 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+#include "Ecs.hpp"
+#include "Input.hpp"
+#include "TripleBuffer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// everything the renderer needs of one simulation tick.
+struct SimulationState
+{
+	double time = 0.0; // simulated seconds.
+	Camera camera{};
+	MouseLook look{}; // of the current tick, for latchCamera().
+};
+
+// the two most recent ticks, the renderer interpolates between them.
+struct SimulationSnapshot
+{
+	uint64_t tick = 0;
+	std::chrono::steady_clock::time_point due; // when `current` was due.
+	SimulationState previous, current;
+};
+
+// runs the camera world on its own thread in fixed steps and publishes a
+// snapshot after every tick. a slow frame no longer slows the simulation and
+// a slow tick no longer delays a frame; the renderer draws the state one
+// step in the past, interpolated to the exact frame time.
+class Simulation final
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	// `rate` ticks per second, the camera is set up for a `width` x `height`
+	// window. every tick drains `input`, the simulation is its consumer.
+	Simulation(double rate, InputQueue &input, float width, float height);
+	~Simulation();
+
+	Simulation(const Simulation &) = delete;
+	Simulation &operator=(const Simulation &) = delete;
+
+	// the state at `now` - one step, call from the render thread only.
+	SimulationState sample(Clock::time_point now);
+
+	double step() const { return tickSeconds; }
+	uint64_t tickCount() const { return ticks.load(std::memory_order_relaxed); }
+	// ticks given up because the simulation fell too far behind.
+	uint64_t droppedTicks() const
+	{
+		return dropped.load(std::memory_order_relaxed);
+	}
+
+  private:
+	void run(Clock::time_point start);
+	void tick(Clock::time_point due);
+
+	double tickSeconds;
+	Clock::duration tickDuration;
+
+	// only touched by the simulation thread once it runs.
+	World world;
+	Entity camera;
+	SimulationState state;
+
+	InputQueue &inputQueue;
+	InputState input;
+
+	TripleBuffer<SimulationSnapshot> snapshots;
+	SimulationSnapshot latest; // render thread copy.
+
+	std::atomic<uint64_t> ticks{0};
+	std::atomic<uint64_t> dropped{0};
+	std::atomic<bool> running{true};
+	std::thread thread;
+};
+
+#endif // SIMULATION_H
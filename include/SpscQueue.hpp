@@ -0,0 +1,65 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+
+// bounded lock free queue between exactly one producer and one consumer
+// thread. `Capacity` has to be a power of two, one slot stays unused.
+template <typename T, std::size_t Capacity> class SpscQueue final
+{
+	static_assert((Capacity & (Capacity - 1)) == 0,
+				  "capacity has to be a power of two");
+
+  public:
+	SpscQueue() = default;
+	SpscQueue(const SpscQueue &) = delete;
+	SpscQueue &operator=(const SpscQueue &) = delete;
+
+	// producer side, false when full. with a `reserve` also false when
+	// fewer than that many slots would stay free, keeping room for values
+	// that must not be dropped.
+	bool push(const T &value, std::size_t reserve = 0)
+	{
+		std::size_t tail = tailIndex.load(std::memory_order_relaxed);
+		if (freeSlots(tail, cachedHead) <= reserve)
+		{
+			cachedHead = headIndex.load(std::memory_order_acquire);
+			if (freeSlots(tail, cachedHead) <= reserve)
+				return false;
+		}
+		items[tail] = value;
+		tailIndex.store((tail + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+	// consumer side, false when empty.
+	bool pop(T &value)
+	{
+		std::size_t head = headIndex.load(std::memory_order_relaxed);
+		if (head == cachedTail)
+		{
+			cachedTail = tailIndex.load(std::memory_order_acquire);
+			if (head == cachedTail)
+				return false;
+		}
+		value = items[head];
+		headIndex.store((head + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+  private:
+	static std::size_t freeSlots(std::size_t tail, std::size_t head)
+	{
+		return (head - tail - 1) & (Capacity - 1);
+	}
+
+	// producer and consumer state on separate cache lines.
+	alignas(64) std::atomic<std::size_t> tailIndex{0};
+	std::size_t cachedHead = 0;
+	alignas(64) std::atomic<std::size_t> headIndex{0};
+	std::size_t cachedTail = 0;
+	alignas(64) T items[Capacity];
+};
+
+#endif // SPSC_QUEUE_H
@@ -0,0 +1,53 @@
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <chrono>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// when the steps between main() and the first frame ran and on which
+// thread. file reads, image decodes and the scene generation run on the
+// job system while the main thread opens the window, the timeline shows
+// how much of that overlaps and how long the main thread still waited.
+class StartupTimeline final
+{
+  public:
+	using Clock = std::chrono::steady_clock;
+
+	StartupTimeline();
+
+	StartupTimeline(const StartupTimeline &) = delete;
+	StartupTimeline &operator=(const StartupTimeline &) = delete;
+
+	// runs `step()` and records it under `name`, which has to outlive the
+	// timeline. paths are shown by their file name. callable from any job
+	// system thread.
+	template <typename F> void measure(const char *name, F &&step)
+	{
+		Clock::time_point begin = Clock::now();
+		std::forward<F>(step)();
+		record(name, begin, Clock::now());
+	}
+	void record(const char *name, Clock::time_point begin,
+				Clock::time_point end);
+
+	// logs the time to the first frame and every step, call right after the
+	// first swap. later calls do nothing.
+	void firstFrame();
+
+  private:
+	struct Step
+	{
+		const char *name;
+		unsigned int thread;
+		double beginMs, endMs;
+	};
+
+	Clock::time_point start;
+	std::mutex lock;
+	std::vector<Step> steps;
+	bool reported = false;
+};
+
+#endif // STARTUP_H
@@ -0,0 +1,101 @@
+#ifndef TRACKED_ALLOCATOR_H
+#define TRACKED_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// a named heap allocator keeping live and peak byte counts, so the memory
+// report can say who holds what. every allocation carries a small header
+// with its size. thread safe.
+class TrackedAllocator final
+{
+  public:
+	static constexpr std::size_t defaultAlignment = 16;
+
+	explicit TrackedAllocator(const char *name);
+
+	TrackedAllocator(const TrackedAllocator &) = delete;
+	TrackedAllocator &operator=(const TrackedAllocator &) = delete;
+
+	void *allocate(std::size_t size, std::size_t align = defaultAlignment);
+	// realloc semantics, only for memory of the default alignment.
+	void *reallocate(void *memory, std::size_t size);
+	void free(void *memory);
+
+	const std::string &name() const { return allocatorName; }
+	std::size_t liveBytes() const { return live.load(std::memory_order_relaxed); }
+	std::size_t peakBytes() const { return peak.load(std::memory_order_relaxed); }
+	uint64_t allocationCount() const
+	{
+		return allocations.load(std::memory_order_relaxed);
+	}
+	uint64_t liveAllocationCount() const
+	{
+		return liveAllocations.load(std::memory_order_relaxed);
+	}
+
+  private:
+	void added(std::size_t size);
+
+	std::string allocatorName;
+	std::atomic<std::size_t> live{0};
+	std::atomic<std::size_t> peak{0};
+	std::atomic<uint64_t> allocations{0};
+	std::atomic<uint64_t> liveAllocations{0};
+};
+
+// the allocator registered under `name`, created on first use. references
+// stay valid until exit.
+TrackedAllocator &
+trackedAllocator(const char *name);
+
+// logs every registered allocator and the global operator new counters.
+void
+reportMemory();
+
+// std allocator drawing from a TrackedAllocator.
+template <typename T> class TrackedStdAllocator
+{
+  public:
+	using value_type = T;
+
+	explicit TrackedStdAllocator(TrackedAllocator &allocator)
+		: allocator(&allocator)
+	{
+	}
+	template <typename U>
+	TrackedStdAllocator(const TrackedStdAllocator<U> &other)
+		: allocator(other.allocator)
+	{
+	}
+
+	T *allocate(std::size_t count)
+	{
+		return static_cast<T *>(allocator->allocate(
+			count * sizeof(T),
+			alignof(T) > TrackedAllocator::defaultAlignment
+				? alignof(T)
+				: TrackedAllocator::defaultAlignment));
+	}
+	void deallocate(T *memory, std::size_t) { allocator->free(memory); }
+
+	template <typename U>
+	bool operator==(const TrackedStdAllocator<U> &other) const
+	{
+		return allocator == other.allocator;
+	}
+	template <typename U>
+	bool operator!=(const TrackedStdAllocator<U> &other) const
+	{
+		return allocator != other.allocator;
+	}
+
+  private:
+	template <typename U> friend class TrackedStdAllocator;
+
+	TrackedAllocator *allocator;
+};
+
+#endif // TRACKED_ALLOCATOR_H
@@ -0,0 +1,79 @@
+#ifndef TRANSFORM_SYSTEM_H
+#define TRANSFORM_SYSTEM_H
+
+#include <glm/glm.hpp>
+
+#include "Allocators.hpp"
+#include "JobSystem.hpp"
+#include "SceneGenerator.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// consecutive slots sharing a mesh and a material, drawn together.
+struct DrawGroup
+{
+	unsigned int mesh;
+	unsigned int material;
+	uint32_t first; // first slot.
+	uint32_t count;
+};
+
+// [first, first + count) slots rewritten by the last update.
+struct SlotRange
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+// world matrices of all scene objects, stored in draw order ("slots"):
+// sorted by mesh and material, the dynamic objects at the end of each group.
+// the matrices are laid out as the instance buffer expects them, static
+// objects are only recomputed after markDirty().
+class TransformSystem final
+{
+  public:
+	explicit TransformSystem(const Scene &scene);
+
+	// recomputes the dirty and the dynamic matrices on all job threads.
+	// `time` in seconds drives the dynamic objects. the list of updated
+	// slots lives in `frame` and is valid until that arena is reset.
+	void update(JobSystem &jobs, float time, LinearArena &frame);
+
+	// skips the update of a frame: nothing is recomputed or uploaded, the
+	// dynamic objects keep last frame's matrices.
+	void holdFrame();
+
+	// arena bytes one update needs at most.
+	std::size_t frameBytes() const;
+
+	// the object (index into scene.objects) moved, recompute it next update.
+	void markDirty(std::size_t object);
+	// true while the next update has matrices to recompute.
+	bool needsUpdate() const
+	{
+		return !dynamicSlots.empty() || !dirtySlots.empty();
+	}
+
+	const std::vector<glm::mat4> &matrices() const { return slotMatrices; }
+	const std::vector<DrawGroup> &groups() const { return drawGroups; }
+	const SlotRange *updatedRanges() const { return ranges; }
+	std::size_t updatedRangeCount() const { return rangeCount; }
+	std::size_t updatedCount() const { return updateCount; }
+
+  private:
+	const Scene &scene;
+	std::vector<uint32_t> slotObjects; // object index of every slot.
+	std::vector<uint32_t> objectSlots; // slot of every object.
+	std::vector<glm::mat4> slotMatrices;
+	std::vector<DrawGroup> drawGroups;
+
+	std::vector<uint32_t> dynamicSlots;
+	std::vector<uint32_t> dirtySlots; // static slots waiting for an update.
+	std::vector<uint8_t> dirty;
+	SlotRange *ranges = nullptr;
+	std::size_t rangeCount = 0;
+	std::size_t updateCount = 0;
+};
+
+#endif // TRANSFORM_SYSTEM_H
@@ -0,0 +1,47 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// hands values from one writer thread to one reader thread without locks or
+// copies. the writer fills back() and publishes it, the reader picks up the
+// newest published value with acquire(). neither ever waits for the other,
+// values published in between are skipped.
+template <typename T> class TripleBuffer final
+{
+  public:
+	TripleBuffer() = default;
+	TripleBuffer(const TripleBuffer &) = delete;
+	TripleBuffer &operator=(const TripleBuffer &) = delete;
+
+	// writer side.
+	T &back() { return buffers[backIndex]; }
+	void publish()
+	{
+		backIndex = middle.exchange(backIndex | freshBit,
+									std::memory_order_acq_rel) &
+					indexMask;
+	}
+
+	// reader side. true when a value newer than front() was published.
+	bool acquire()
+	{
+		if ((middle.load(std::memory_order_relaxed) & freshBit) == 0)
+			return false;
+		frontIndex =
+			middle.exchange(frontIndex, std::memory_order_acq_rel) & indexMask;
+		return true;
+	}
+	const T &front() const { return buffers[frontIndex]; }
+
+  private:
+	static constexpr unsigned int freshBit = 4;
+	static constexpr unsigned int indexMask = 3;
+
+	T buffers[3] = {};
+	unsigned int backIndex = 0;
+	unsigned int frontIndex = 1;
+	std::atomic<unsigned int> middle{2};
+};
+
+#endif // TRIPLE_BUFFER_H
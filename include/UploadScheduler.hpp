@@ -0,0 +1,100 @@
+#ifndef UPLOAD_SCHEDULER_H
+#define UPLOAD_SCHEDULER_H
+
+#include <glad/glad.h>
+
+#include "TrackedAllocator.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+// data waiting to be uploaded, owned by the scheduler.
+using UploadBytes =
+	std::vector<unsigned char, TrackedStdAllocator<unsigned char>>;
+
+// the order pending uploads are served in, visible first.
+enum class UploadPriority
+{
+	Visible,
+	Soon,
+	Background,
+};
+
+struct UploadStats
+{
+	uint64_t frameBytes = 0;   // uploaded by the last process().
+	unsigned int queued = 0;   // uploads not finished yet.
+	uint64_t pendingBytes = 0; // bytes they still have to upload.
+	uint64_t totalBytes = 0;
+	uint64_t frames = 0; // process() calls that uploaded anything.
+};
+
+// spreads texture and buffer uploads over frames so a burst of loads does
+// not land in a single one. every process() uploads at most the per frame
+// budget: textures row band by row band with glTexSubImage2D, buffers in
+// chunks with glBufferSubData. storage is allocated when an upload is
+// queued, so the objects can be bound right away; a texture samples only
+// its base level, with undefined contents, until its mipmaps are built
+// after the last band. needs a current GL context.
+class UploadScheduler final
+{
+  public:
+	// 0 = no budget, everything queued is uploaded by the next process().
+	explicit UploadScheduler(uint64_t budgetBytes = 0);
+
+	UploadScheduler(const UploadScheduler &) = delete;
+	UploadScheduler &operator=(const UploadScheduler &) = delete;
+
+	// allocates `width` x `height` of `internalFormat` for `texture` and
+	// queues the tightly packed `pixels` of format/type for level 0. an
+	// empty texture or `pixels` only allocates, nothing is queued.
+	void uploadTexture(GLuint texture, GLint internalFormat, GLsizei width,
+					   GLsizei height, GLenum format, GLenum type,
+					   UploadBytes pixels, UploadPriority priority,
+					   bool mipmaps = true);
+	// queues `bytes` for [offset, offset + size) of `buffer`, whose storage
+	// has to exist already. empty `bytes` queue nothing.
+	void uploadBuffer(GLuint buffer, GLintptr offset, UploadBytes bytes,
+					  UploadPriority priority);
+
+	// uploads up to the budget, call once per frame before drawing.
+	// changes the GL_TEXTURE_2D binding of the active texture unit.
+	void process();
+	// uploads everything queued, regardless of the budget.
+	void flush();
+
+	bool pending() const { return queued != 0; }
+	uint64_t budget() const { return budgetBytes; }
+	const UploadStats &stats() const { return uploadStats; }
+	void report() const;
+
+  private:
+	struct Upload
+	{
+		GLuint object;
+		bool texture;
+		bool mipmaps;
+		GLsizei width, height; // textures only.
+		GLenum format, type;
+		std::size_t rowBytes;
+		GLintptr offset; // buffers only.
+		UploadBytes bytes{
+			TrackedStdAllocator<unsigned char>(trackedAllocator("uploads"))};
+		std::size_t done = 0; // bytes, or rows of a texture.
+	};
+
+	// uploads at most `limit` bytes of `upload`, returns how many it did.
+	// with `force` at least one row or chunk, so every frame progresses.
+	uint64_t advance(Upload &upload, uint64_t limit, bool force);
+	void upload(uint64_t limit);
+
+	static constexpr unsigned int priorityCount = 3;
+
+	uint64_t budgetBytes;
+	std::deque<Upload> queues[priorityCount];
+	unsigned int queued = 0;
+	UploadStats uploadStats;
+};
+
+#endif // UPLOAD_SCHEDULER_H
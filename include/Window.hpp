@@ -0,0 +1,20 @@
+#ifndef WINDOW_H
+#define WINDOW_H
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+#include "GLLoader.hpp"
+
+// initializes glfw, opens a window with a 4.1 core context, makes it current
+// and loads the GL functions. returns NULL (with glfw terminated again) when
+// any of that fails. hidden windows are used for headless runs, debug
+// contexts for installGLDebug(). logs how long each step took, the time
+// until the first GL call can be made.
+GLFWwindow *
+createWindow(int width, int height, const char *title, bool visible = true,
+			 bool debug = false, GLLoadMode load = GLLoadMode::Full);
+
+#endif // WINDOW_H
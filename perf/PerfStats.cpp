@@ -0,0 +1,138 @@
+#include "PerfStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+
+double
+percentile(const std::vector<double> &sorted, double fraction)
+{
+	if (sorted.empty())
+		return 0.0;
+	double position = fraction * (sorted.size() - 1);
+	std::size_t below = static_cast<std::size_t>(position);
+	std::size_t above = std::min(below + 1, sorted.size() - 1);
+	double weight = position - below;
+	return sorted[below] * (1.0 - weight) + sorted[above] * weight;
+}
+
+// value of `"key": <number>` after `from` in `text`.
+bool
+findNumber(const std::string &text, std::size_t from, const char *key,
+		   double &value)
+{
+	std::string quoted = std::string("\"") + key + "\":";
+	std::size_t at = text.find(quoted, from);
+	if (at == std::string::npos)
+		return false;
+	value = std::strtod(text.c_str() + at + quoted.size(), nullptr);
+	return true;
+}
+
+} // namespace
+
+MetricStats
+computeStats(std::vector<double> samples)
+{
+	MetricStats stats;
+	if (samples.empty())
+		return stats;
+
+	std::sort(samples.begin(), samples.end());
+	stats.median = percentile(samples, 0.5);
+	stats.p95 = percentile(samples, 0.95);
+	stats.min = samples.front();
+	stats.max = samples.back();
+
+	double sum = 0.0;
+	for (double sample : samples)
+		sum += sample;
+	stats.mean = sum / samples.size();
+
+	std::vector<double> deviations;
+	deviations.reserve(samples.size());
+	for (double sample : samples)
+		deviations.push_back(std::fabs(sample - stats.median));
+	std::sort(deviations.begin(), deviations.end());
+	stats.mad = percentile(deviations, 0.5);
+	return stats;
+}
+
+bool
+writeMetrics(const std::string &path, const std::string &scene,
+			 unsigned int frames, const MetricList &metrics)
+{
+	FILE *file = std::fopen(path.c_str(), "w");
+	if (file == nullptr)
+		return false;
+
+	std::fprintf(file, "{\n  \"scene\": \"%s\",\n  \"frames\": %u,\n",
+				 scene.c_str(), frames);
+	std::fprintf(file, "  \"metrics\": {");
+	for (std::size_t i = 0; i < metrics.size(); i++)
+	{
+		const MetricStats &stats = metrics[i].second;
+		std::fprintf(file,
+					 "%s\n    \"%s\": {\"median\": %.6f, \"mad\": %.6f, "
+					 "\"mean\": %.6f, \"p95\": %.6f, \"min\": %.6f, "
+					 "\"max\": %.6f}",
+					 i == 0 ? "" : ",", metrics[i].first.c_str(), stats.median,
+					 stats.mad, stats.mean, stats.p95, stats.min, stats.max);
+	}
+	std::fprintf(file, "\n  }\n}\n");
+	std::fclose(file);
+	return true;
+}
+
+bool
+readMetrics(const std::string &path, MetricList &metrics)
+{
+	std::ifstream file(path);
+	if (!file)
+		return false;
+	std::string text((std::istreambuf_iterator<char>(file)),
+					 std::istreambuf_iterator<char>());
+
+	std::size_t at = text.find("\"metrics\"");
+	if (at == std::string::npos)
+		return false;
+
+	metrics.clear();
+	// every metric is one `"name": {...}` object on its own line.
+	while ((at = text.find("\n    \"", at)) != std::string::npos)
+	{
+		std::size_t nameBegin = at + 6;
+		std::size_t nameEnd = text.find('"', nameBegin);
+		if (nameEnd == std::string::npos)
+			return false;
+
+		MetricStats stats;
+		bool ok = findNumber(text, nameEnd, "median", stats.median) &&
+				  findNumber(text, nameEnd, "mad", stats.mad) &&
+				  findNumber(text, nameEnd, "mean", stats.mean) &&
+				  findNumber(text, nameEnd, "p95", stats.p95) &&
+				  findNumber(text, nameEnd, "min", stats.min) &&
+				  findNumber(text, nameEnd, "max", stats.max);
+		if (!ok)
+			return false;
+		metrics.emplace_back(text.substr(nameBegin, nameEnd - nameBegin),
+							 stats);
+		at = nameEnd;
+	}
+	return !metrics.empty();
+}
+
+double
+regressionLimit(const MetricStats &baseline, const RegressionCheck &check)
+{
+	// 1.4826 * mad estimates the standard deviation of normal data.
+	double robustSigma = 1.4826 * baseline.mad;
+	return std::max(baseline.median * (1.0 + check.threshold),
+					baseline.median + check.sigma * robustSigma);
+}
@@ -0,0 +1,44 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// summary of the per frame samples of one metric, all in milliseconds.
+struct MetricStats
+{
+	double median = 0.0;
+	double mad = 0.0; // median absolute deviation.
+	double mean = 0.0;
+	double p95 = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+};
+
+using MetricList = std::vector<std::pair<std::string, MetricStats>>;
+
+MetricStats
+computeStats(std::vector<double> samples);
+
+bool
+writeMetrics(const std::string &path, const std::string &scene,
+			 unsigned int frames, const MetricList &metrics);
+
+// only understands the files written by writeMetrics.
+bool
+readMetrics(const std::string &path, MetricList &metrics);
+
+// a metric regressed when its median is both `threshold` (relative) slower
+// than the baseline median and outside `sigma` robust standard deviations
+// of the baseline, so noisy metrics do not fail on jitter alone.
+struct RegressionCheck
+{
+	double threshold = 0.15;
+	double sigma = 3.0;
+};
+
+double
+regressionLimit(const MetricStats &baseline, const RegressionCheck &check);
+
+#endif // PERF_STATS_H
@@ -0,0 +1,328 @@
+// renders one of the fixed scenes headlessly for a number of frames and
+// compares the frame metrics with a stored baseline, see CMakeLists.txt for
+// how the scenes are registered with ctest.
+#include "PerfStats.hpp"
+
+#include "AllocationCounter.hpp"
+#include "Allocators.hpp"
+#include "FrameSync.hpp"
+#include "JobSystem.hpp"
+#include "Options.hpp"
+#include "Renderer.hpp"
+#include "SceneGenerator.hpp"
+#include "TransformSystem.hpp"
+#include "UploadScheduler.hpp"
+#include "Window.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+// exit code ctest treats as skipped, used when there is no GL context.
+constexpr int skipExitCode = 77;
+
+// more frames than any run should take, catches typos.
+constexpr unsigned long long maxFrames = 1000000;
+
+struct PerfScene
+{
+	const char *name;
+	SceneDistribution distribution;
+	std::size_t objectCount;
+	float dynamicRatio;
+};
+
+const PerfScene perfScenes[] = {
+	{"tutorial", SceneDistribution::Tutorial, 10, 0.0f},
+	{"uniform-10k", SceneDistribution::Uniform, 10000, 0.0f},
+	{"clustered-20k", SceneDistribution::Clustered, 20000, 0.0f},
+	{"city-20k-dynamic", SceneDistribution::City, 20000, 0.25f},
+};
+
+const PerfScene *
+findScene(const char *name)
+{
+	for (const PerfScene &scene : perfScenes)
+		if (std::strcmp(scene.name, name) == 0)
+			return &scene;
+	return nullptr;
+}
+
+void
+printUsage(const char *program)
+{
+	std::string names;
+	for (const PerfScene &scene : perfScenes)
+		names += std::string(" ") + scene.name;
+	spdlog::info("usage: {} --scene NAME [options]\n"
+				 "  --scene NAME         one of:{}\n"
+				 "  --frames N           measured frames\n"
+				 "  --warmup N           frames rendered before measuring\n"
+				 "  --baseline-dir DIR   where baselines are stored\n"
+				 "  --threshold F        allowed relative slowdown\n"
+				 "  --sigma F            allowed deviations from the baseline\n"
+				 "  --update-baseline    overwrite the stored baseline\n"
+				 "  --json PATH          also write this run's metrics\n"
+				 "  --submit MODE        uniform or instanced matrices\n"
+				 "  --workers N          job system threads, 0 = auto\n"
+				 "  --allow-allocations  do not fail when frames allocate",
+				 program, names);
+}
+
+// cpu time of the calling thread. std::clock() counts the whole process,
+// including workers waiting for jobs, which is not frame cost.
+double
+cpuMilliseconds()
+{
+	timespec time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return time.tv_sec * 1000.0 + time.tv_nsec / 1e6;
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+	const PerfScene *perfScene = nullptr;
+	unsigned int frames = 120;
+	unsigned int warmup = 10;
+	std::string baselineDir = ".";
+	std::string jsonPath;
+	bool updateBaseline = false;
+	RegressionCheck check;
+	SubmitMode submit = SubmitMode::Instanced;
+	unsigned int workers = 0;
+	bool allowAllocations = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		bool hasValue = i + 1 < argc;
+		unsigned long long number = 0;
+		if (std::strcmp(arg, "--scene") == 0 && hasValue)
+		{
+			perfScene = findScene(argv[++i]);
+			if (perfScene == nullptr)
+			{
+				spdlog::error("Unknown scene {}", argv[i]);
+				return 2;
+			}
+		}
+		else if (std::strcmp(arg, "--frames") == 0 && hasValue)
+		{
+			if (!parseUnsigned(argv[++i], number) || number == 0 ||
+				number > maxFrames)
+			{
+				spdlog::error("Invalid frame count {}", argv[i]);
+				return 2;
+			}
+			frames = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--warmup") == 0 && hasValue)
+		{
+			if (!parseUnsigned(argv[++i], number) || number > maxFrames)
+			{
+				spdlog::error("Invalid warmup frame count {}", argv[i]);
+				return 2;
+			}
+			warmup = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--baseline-dir") == 0 && hasValue)
+			baselineDir = argv[++i];
+		else if ((std::strcmp(arg, "--threshold") == 0 ||
+				  std::strcmp(arg, "--sigma") == 0) &&
+				 hasValue)
+		{
+			double &target = std::strcmp(arg, "--threshold") == 0
+								 ? check.threshold
+								 : check.sigma;
+			float value = 0.0f;
+			if (!parseFloat(argv[++i], value) || !(value >= 0.0f))
+			{
+				spdlog::error("Invalid value '{}' for option {}", argv[i], arg);
+				return 2;
+			}
+			target = value;
+		}
+		else if (std::strcmp(arg, "--update-baseline") == 0)
+			updateBaseline = true;
+		else if (std::strcmp(arg, "--json") == 0 && hasValue)
+			jsonPath = argv[++i];
+		else if (std::strcmp(arg, "--submit") == 0 && hasValue)
+		{
+			if (!parseSubmitMode(argv[++i], submit))
+			{
+				spdlog::error("Unknown submit mode {}", argv[i]);
+				return 2;
+			}
+		}
+		else if (std::strcmp(arg, "--workers") == 0 && hasValue)
+		{
+			if (!parseUnsigned(argv[++i], number))
+			{
+				spdlog::error("Invalid worker count {}", argv[i]);
+				return 2;
+			}
+			workers = clampWorkers(number);
+		}
+		else if (std::strcmp(arg, "--allow-allocations") == 0)
+			allowAllocations = true;
+		else
+		{
+			printUsage(argv[0]);
+			return std::strcmp(arg, "--help") == 0 ? 0 : 2;
+		}
+	}
+	if (perfScene == nullptr)
+	{
+		printUsage(argv[0]);
+		return 2;
+	}
+
+	GLFWwindow *window = createWindow(800, 600, "perf", false);
+	if (window == NULL)
+	{
+		spdlog::warn("No GL context available, skipping {}", perfScene->name);
+		return skipExitCode;
+	}
+	spdlog::info("GL renderer: {}",
+				 reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+
+	SceneDesc desc;
+	desc.distribution = perfScene->distribution;
+	desc.objectCount = perfScene->objectCount;
+	desc.dynamicRatio = perfScene->dynamicRatio;
+	desc.meshVariety = Renderer::meshCount;
+	desc.materialVariety = Renderer::materialCount;
+	Scene scene = generateScene(desc);
+
+	std::vector<double> frameMs, submitMs, cpuMs;
+	frameMs.reserve(frames);
+	submitMs.reserve(frames);
+	cpuMs.reserve(frames);
+	uint64_t allocations = 0;
+	{
+		JobSystem jobs(workers);
+		TransformSystem transforms(scene);
+		// every frame ends in glFinish, one frame in flight is all there is.
+		FrameSync frameSync(1);
+		// no budget, the assets are in before the first frame.
+		UploadScheduler uploads;
+		RendererAssets assets;
+		JobCounter assetsLoaded;
+		loadRendererAssets(jobs, assets, assetsLoaded);
+		jobs.wait(assetsLoaded);
+		Renderer renderer(scene, submit, frameSync, uploads, assets);
+		uploads.flush();
+		FrameArena frameArena(transforms.frameBytes());
+		glViewport(0, 0, 800, 600);
+
+		// a fixed camera outside the scene looking at its center.
+		glm::vec3 eye(0.0f, 0.3f * scene.radius, 1.2f * scene.radius + 3.0f);
+		glm::mat4 view = glm::lookAt(eye, glm::vec3(0.0f),
+									 glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 projection = glm::perspective(
+			glm::radians(45.0f), 800.0f / 600.0f, 0.1f,
+			renderer.farPlane() + glm::length(eye));
+
+		using Clock = std::chrono::steady_clock;
+		uint64_t allocationsStart = 0;
+		for (unsigned int frame = 0; frame < warmup + frames; frame++)
+		{
+			if (frame == warmup)
+				allocationsStart = heapAllocationCount();
+			Clock::time_point start = Clock::now();
+			double cpuStart = cpuMilliseconds();
+
+			// fixed simulation time so every run draws the same frames.
+			frameSync.beginFrame();
+			frameArena.beginFrame();
+			transforms.update(jobs, frame / 60.0f, frameArena.current());
+			renderer.draw(view, projection, transforms);
+			frameSync.endFrame();
+			Clock::time_point submitted = Clock::now();
+			glfwSwapBuffers(window);
+			glFinish();
+
+			Clock::time_point end = Clock::now();
+			if (frame < warmup)
+				continue;
+			frameMs.push_back(
+				std::chrono::duration<double, std::milli>(end - start).count());
+			submitMs.push_back(std::chrono::duration<double, std::milli>(
+								   submitted - start)
+								   .count());
+			cpuMs.push_back(cpuMilliseconds() - cpuStart);
+		}
+		allocations = heapAllocationCount() - allocationsStart;
+	}
+	glfwTerminate();
+
+	MetricList metrics = {{"frame_ms", computeStats(frameMs)},
+						  {"submit_ms", computeStats(submitMs)},
+						  {"cpu_ms", computeStats(cpuMs)}};
+	for (const auto &metric : metrics)
+		spdlog::info("{:<10} median {:8.3f} ms  mad {:7.3f}  p95 {:8.3f}",
+					 metric.first, metric.second.median, metric.second.mad,
+					 metric.second.p95);
+
+	if (!jsonPath.empty() &&
+		!writeMetrics(jsonPath, perfScene->name, frames, metrics))
+		spdlog::error("Failed to write {}", jsonPath);
+
+	std::string baselinePath =
+		baselineDir + "/" + perfScene->name + ".baseline.json";
+	MetricList baseline;
+	if (updateBaseline || !readMetrics(baselinePath, baseline))
+	{
+		std::error_code error;
+		std::filesystem::create_directories(baselineDir, error);
+		if (!writeMetrics(baselinePath, perfScene->name, frames, metrics))
+		{
+			spdlog::error("Failed to write baseline {}", baselinePath);
+			return 1;
+		}
+		spdlog::info("Recorded baseline {}", baselinePath);
+		return 0;
+	}
+
+	// steady state frames are expected not to touch the heap at all.
+	bool regressed = false;
+	if (allocations != 0)
+	{
+		spdlog::log(allowAllocations ? spdlog::level::warn : spdlog::level::err,
+					"{} heap allocations in {} measured frames", allocations,
+					frames);
+		regressed = !allowAllocations;
+	}
+	for (const auto &metric : metrics)
+	{
+		for (const auto &reference : baseline)
+		{
+			if (reference.first != metric.first)
+				continue;
+			double limit = regressionLimit(reference.second, check);
+			bool failed = metric.second.median > limit;
+			regressed = regressed || failed;
+			spdlog::log(failed ? spdlog::level::err : spdlog::level::info,
+						"{:<10} {:8.3f} ms vs baseline {:8.3f} ms (limit "
+						"{:8.3f}) {}",
+						metric.first, metric.second.median,
+						reference.second.median, limit,
+						failed ? "REGRESSED" : "ok");
+		}
+	}
+	return regressed ? 1 : 0;
+}
@@ -0,0 +1,228 @@
+// re-issues a GL command stream recorded with --capture, without any of the
+// application logic, to measure what the driver does with the same calls.
+// the frames after the setup part are replayed --loops times.
+#include "PerfStats.hpp"
+
+#include "GLTrace.hpp"
+#include "Window.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+const GLReplayFunction replayFunctions[] = {
+#define GLAD_FUNCTION(name)                                                    \
+	&GLReplay<id_##name, decltype(glad_##name), &glad_##name>::call,
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+};
+
+void
+printUsage(const char *program)
+{
+	spdlog::info("usage: {} TRACE [options]\n"
+				 "  --loops N            times the captured frames are replayed\n"
+				 "  --windowed           show the window while replaying\n"
+				 "  --finish             wait for the gpu after every frame",
+				 program);
+}
+
+// maps the function indices of the trace to the local dispatch table.
+bool
+readHeader(GLTraceReader &reader, std::vector<GLReplayFunction> &functions)
+{
+	char magic[4];
+	for (char &c : magic)
+		c = reader.read<char>();
+	if (std::memcmp(magic, "GLTR", 4) != 0)
+	{
+		spdlog::error("Not a GL trace");
+		return false;
+	}
+	uint32_t version = reader.read<uint32_t>();
+	if (version != glTraceVersion)
+	{
+		spdlog::error("Trace version {} unsupported, expected {}", version,
+					  glTraceVersion);
+		return false;
+	}
+
+	std::unordered_map<std::string, unsigned int> localIds;
+	for (unsigned int id = 0; id < glFunctionCount; id++)
+		localIds[glFunctionNames[id]] = id;
+
+	uint32_t count = reader.read<uint32_t>();
+	functions.assign(count, nullptr);
+	for (uint32_t i = 0; i < count && !reader.failed(); i++)
+	{
+		uint16_t length = reader.read<uint16_t>();
+		std::string name(length, '\0');
+		for (char &c : name)
+			c = reader.read<char>();
+		auto found = localIds.find(name);
+		if (found != localIds.end())
+			functions[i] = replayFunctions[found->second];
+	}
+	return !reader.failed();
+}
+
+enum class Step
+{
+	Call,
+	FrameEnd,
+	End,
+	Error,
+};
+
+Step
+replayRecord(GLTraceReader &reader, GLReplayState &state,
+			 const std::vector<GLReplayFunction> &functions)
+{
+	if (reader.atEnd())
+		return Step::End;
+
+	uint16_t id = reader.read<uint16_t>();
+	if (id == glTraceFrameEnd)
+		return Step::FrameEnd;
+
+	if (id == glTraceMapWrite)
+	{
+		GLenum target = reader.read<uint32_t>();
+		uint32_t size;
+		const unsigned char *data = reader.readBlob(size);
+		auto found = state.mappings.find(target);
+		if (found != state.mappings.end() && found->second != nullptr &&
+			data != nullptr)
+			std::memcpy(found->second, data, size);
+		return reader.failed() ? Step::Error : Step::Call;
+	}
+
+	// without the local function the argument sizes are unknown.
+	if (id >= functions.size() || functions[id] == nullptr)
+	{
+		spdlog::error("Unknown function {} at offset {}", id, reader.tell());
+		return Step::Error;
+	}
+	functions[id](reader, state);
+	return reader.failed() ? Step::Error : Step::Call;
+}
+
+} // namespace
+
+int
+main(int argc, char **argv)
+{
+	const char *tracePath = nullptr;
+	unsigned int loops = 10;
+	bool windowed = false;
+	bool finish = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		if (std::strcmp(arg, "--loops") == 0 && i + 1 < argc)
+			loops = std::max(1, std::atoi(argv[++i]));
+		else if (std::strcmp(arg, "--windowed") == 0)
+			windowed = true;
+		else if (std::strcmp(arg, "--finish") == 0)
+			finish = true;
+		else if (arg[0] != '-' && tracePath == nullptr)
+			tracePath = arg;
+		else
+		{
+			printUsage(argv[0]);
+			return std::strcmp(arg, "--help") == 0 ? 0 : 2;
+		}
+	}
+	if (tracePath == nullptr)
+	{
+		printUsage(argv[0]);
+		return 2;
+	}
+
+	GLTraceReader reader;
+	std::vector<GLReplayFunction> functions;
+	if (!reader.open(tracePath))
+	{
+		spdlog::error("Failed to open {}", tracePath);
+		return 1;
+	}
+	if (!readHeader(reader, functions))
+		return 1;
+
+	GLFWwindow *window = createWindow(800, 600, "replay", windowed);
+	if (window == NULL)
+		return 1;
+	glfwSwapInterval(0);
+
+	// the setup part creates the objects the frames use, it runs once.
+	GLReplayState state;
+	Step step;
+	while ((step = replayRecord(reader, state, functions)) == Step::Call)
+		;
+	if (step != Step::FrameEnd)
+	{
+		spdlog::error("Trace has no complete frame");
+		glfwTerminate();
+		return 1;
+	}
+	glfwSwapBuffers(window);
+	std::size_t framesStart = reader.tell();
+
+	using Clock = std::chrono::steady_clock;
+	std::vector<double> frameMs;
+	uint64_t calls = 0;
+	Clock::time_point replayStart = Clock::now();
+	for (unsigned int loop = 0; loop < loops && step != Step::Error; loop++)
+	{
+		reader.seek(framesStart);
+		Clock::time_point frameStart = Clock::now();
+		while ((step = replayRecord(reader, state, functions)) != Step::End &&
+			   step != Step::Error)
+		{
+			if (step == Step::Call)
+			{
+				calls++;
+				continue;
+			}
+			glfwSwapBuffers(window);
+			if (finish)
+				glFinish();
+			glfwPollEvents();
+
+			Clock::time_point now = Clock::now();
+			frameMs.push_back(
+				std::chrono::duration<double, std::milli>(now - frameStart)
+					.count());
+			frameStart = now;
+		}
+	}
+	double seconds =
+		std::chrono::duration<double>(Clock::now() - replayStart).count();
+	glfwTerminate();
+
+	if (step == Step::Error)
+	{
+		spdlog::error("Trace is corrupt at offset {}", reader.tell());
+		return 1;
+	}
+	if (state.mismatches != 0)
+		spdlog::warn("{} results differed from the capture", state.mismatches);
+
+	MetricStats stats = computeStats(frameMs);
+	spdlog::info("Replayed {} frames, {} calls in {:.3f} s ({:.0f} calls/s)",
+				 frameMs.size(), calls, seconds,
+				 seconds > 0.0 ? calls / seconds : 0.0);
+	spdlog::info("frame_ms median {:8.3f}  mad {:7.3f}  p95 {:8.3f}  max {:8.3f}",
+				 stats.median, stats.mad, stats.p95, stats.max);
+	return 0;
+}
@@ -0,0 +1,131 @@
+#include "AllocationCounter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// replacing the global operators is the only way to see every allocation of
+// the standard containers. relaxed counters keep it cheap enough to leave on.
+
+namespace
+{
+
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocatedBytes{0};
+
+void *
+countedAllocate(std::size_t size, std::size_t align, bool nothrow)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+	if (size == 0)
+		size = 1;
+
+	void *memory;
+	if (align <= alignof(std::max_align_t))
+		memory = std::malloc(size);
+	else
+		memory = std::aligned_alloc(align, (size + align - 1) / align * align);
+	if (memory == nullptr && !nothrow)
+		throw std::bad_alloc();
+	return memory;
+}
+
+} // namespace
+
+uint64_t
+heapAllocationCount()
+{
+	return allocations.load(std::memory_order_relaxed);
+}
+
+uint64_t
+heapAllocatedBytes()
+{
+	return allocatedBytes.load(std::memory_order_relaxed);
+}
+
+void *
+operator new(std::size_t size)
+{
+	return countedAllocate(size, 0, false);
+}
+
+void *
+operator new[](std::size_t size)
+{
+	return countedAllocate(size, 0, false);
+}
+
+void *
+operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+	return countedAllocate(size, 0, true);
+}
+
+void *
+operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+	return countedAllocate(size, 0, true);
+}
+
+void *
+operator new(std::size_t size, std::align_val_t align)
+{
+	return countedAllocate(size, static_cast<std::size_t>(align), false);
+}
+
+void *
+operator new[](std::size_t size, std::align_val_t align)
+{
+	return countedAllocate(size, static_cast<std::size_t>(align), false);
+}
+
+void
+operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete[](void *memory) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete(void *memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete[](void *memory, std::size_t) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete(void *memory, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete[](void *memory, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete(void *memory, std::size_t, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
+
+void
+operator delete[](void *memory, std::size_t, std::align_val_t) noexcept
+{
+	std::free(memory);
+}
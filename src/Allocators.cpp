@@ -0,0 +1,90 @@
+#include "Allocators.hpp"
+#include "TrackedAllocator.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace
+{
+
+// arena blocks start on a cache line.
+constexpr std::size_t blockAlignment = 64;
+
+TrackedAllocator &
+arenaAllocator()
+{
+	static TrackedAllocator &allocator = trackedAllocator("arenas");
+	return allocator;
+}
+
+} // namespace
+
+LinearArena::LinearArena(std::size_t capacity)
+	: block(static_cast<unsigned char *>(
+		  arenaAllocator().allocate(capacity, blockAlignment))),
+	  size(capacity)
+{
+}
+
+LinearArena::~LinearArena()
+{
+	reset();
+	arenaAllocator().free(block);
+}
+
+void *
+LinearArena::allocate(std::size_t bytes, std::size_t align)
+{
+	std::size_t start = (offset + align - 1) & ~(align - 1);
+	if (start + bytes <= size)
+	{
+		offset = start + bytes;
+		peakUsed = std::max(peakUsed, offset + overflowBytes);
+		return block + start;
+	}
+
+	if (!warned)
+	{
+		spdlog::warn("Arena of {} KiB exhausted, falling back to the heap",
+					 size / 1024);
+		warned = true;
+	}
+	// nothing in the engine asks for more than a cache line of alignment.
+	overflow.push_back(arenaAllocator().allocate(bytes, blockAlignment));
+	overflowBytes += bytes;
+	peakUsed = std::max(peakUsed, offset + overflowBytes);
+	return overflow.back();
+}
+
+void
+LinearArena::reset()
+{
+	for (void *memory : overflow)
+		arenaAllocator().free(memory);
+	overflow.clear();
+	overflowBytes = 0;
+	offset = 0;
+}
+
+FrameArena::FrameArena(std::size_t capacityPerFrame, unsigned int frames)
+{
+	for (unsigned int i = 0; i < std::max(1u, frames); i++)
+		arenas.push_back(std::make_unique<LinearArena>(capacityPerFrame));
+}
+
+void
+FrameArena::beginFrame()
+{
+	index = (index + 1) % arenas.size();
+	arenas[index]->reset();
+}
+
+std::size_t
+FrameArena::peak() const
+{
+	std::size_t peak = 0;
+	for (const std::unique_ptr<LinearArena> &arena : arenas)
+		peak = std::max(peak, arena->peak());
+	return peak;
+}
@@ -0,0 +1,134 @@
+#include "BudgetGovernor.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace
+{
+
+// each level gives up a little more than the one before.
+constexpr QualityLevel levels[] = {
+	{0.0f, 1.0f, 1},
+	{0.5f, 1.0f, 1},
+	{1.0f, 0.85f, 1},
+	{1.0f, 0.7f, 2},
+	{2.0f, 0.5f, 4},
+};
+constexpr unsigned int levelTotal = sizeof(levels) / sizeof(levels[0]);
+
+template <typename T>
+bool
+above(T value, T limit, double factor)
+{
+	return limit > T(0) && value > limit * factor;
+}
+
+} // namespace
+
+BudgetGovernor::BudgetGovernor(const FrameBudget &budget, bool renderScale)
+	: limits(budget), renderScale(renderScale)
+{
+	if (!limits.enabled())
+		return;
+	spdlog::info("Frame budget: {} draws, {} triangles, {} KiB uploads, "
+				 "{:.2f} ms cpu, {:.2f} ms gpu (0 = unlimited)",
+				 limits.drawCalls, limits.triangles, limits.uploadBytes / 1024,
+				 limits.cpuMs, limits.gpuMs);
+}
+
+unsigned int
+BudgetGovernor::levelCount() const
+{
+	return levelTotal;
+}
+
+const QualityLevel &
+BudgetGovernor::quality() const
+{
+	return levels[current];
+}
+
+const char *
+BudgetGovernor::exceeded(const FrameCost &cost, double factor) const
+{
+	if (above(cost.uploadBytes, limits.uploadBytes, factor))
+		return "upload bytes";
+	if (above(cost.cpuMs, limits.cpuMs, factor))
+		return "cpu time";
+	if (above(cost.gpuMs, limits.gpuMs, factor))
+		return "gpu time";
+	return nullptr;
+}
+
+bool
+BudgetGovernor::update(const FrameCost &cost)
+{
+	if (!limits.enabled())
+		return false;
+
+	if (!unreducible && (above(cost.drawCalls, limits.drawCalls, 1.0) ||
+						 above(cost.triangles, limits.triangles, 1.0)))
+	{
+		spdlog::warn("Frame budget: {} draws, {} triangles over budget, no "
+					 "quality level reduces them",
+					 cost.drawCalls, cost.triangles);
+		unreducible = true;
+	}
+
+	const char *reason = exceeded(cost, 1.0);
+	over = reason != nullptr ? over + 1 : 0;
+	under = exceeded(cost, headroom) == nullptr ? under + 1 : 0;
+
+	if (cooldown != 0)
+	{
+		cooldown--;
+		return false;
+	}
+
+	if (over >= overFrames)
+	{
+		over = 0;
+		if (current + 1 == levelTotal)
+		{
+			if (!exhausted)
+				spdlog::warn("Frame budget: {} over budget at the lowest "
+							 "quality level",
+							 reason);
+			exhausted = true;
+			return false;
+		}
+		current++;
+		cooldown = settleFrames;
+		spdlog::info("Frame budget: {} over budget ({} KiB uploaded, {:.2f} "
+					 "ms cpu, {:.2f} ms gpu)",
+					 reason, cost.uploadBytes / 1024, cost.cpuMs, cost.gpuMs);
+		logLevel("down");
+		return true;
+	}
+
+	if (under >= underFrames && current != 0)
+	{
+		under = 0;
+		exhausted = false;
+		current--;
+		cooldown = settleFrames;
+		spdlog::info("Frame budget: headroom for {} frames", underFrames);
+		logLevel("up");
+		return true;
+	}
+	return false;
+}
+
+void
+BudgetGovernor::logLevel(const char *change) const
+{
+	const QualityLevel &level = levels[current];
+	if (renderScale)
+		spdlog::info("Frame budget: quality {} to level {}: lod bias {:.1f}, "
+					 "render scale <= {:.2f}, animation every {} frames",
+					 change, current, level.lodBias, level.maxRenderScale,
+					 level.updateInterval);
+	else
+		spdlog::info("Frame budget: quality {} to level {}: lod bias {:.1f}, "
+					 "animation every {} frames",
+					 change, current, level.lodBias, level.updateInterval);
+}
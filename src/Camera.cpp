@@ -0,0 +1,130 @@
+#include "Camera.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// points the camera at the cursor position (x, y).
+void
+turnCamera(Camera &camera, MouseLook &look, double x, double y)
+{
+	if (look.firstMouse)
+	{
+		look.lastX = x;
+		look.lastY = y;
+		look.firstMouse = false;
+	}
+
+	float xoffset = (x - look.lastX) * look.sensitivity;
+	float yoffset = (look.lastY - y) * look.sensitivity;
+	look.lastX = x;
+	look.lastY = y;
+
+	camera.yaw += xoffset;
+	camera.pitch = std::clamp(camera.pitch + yoffset, -89.0f, 89.0f);
+
+	glm::vec3 direction;
+	direction.x = std::cos(glm::radians(camera.yaw)) *
+				  std::cos(glm::radians(camera.pitch));
+	direction.y = std::sin(glm::radians(camera.pitch));
+	direction.z = std::sin(glm::radians(camera.yaw)) *
+				  std::cos(glm::radians(camera.pitch));
+	camera.front = glm::normalize(direction);
+}
+
+} // namespace
+
+Entity
+spawnCamera(World &world, float width, float height)
+{
+	Camera camera;
+	camera.position = glm::vec3(0.0f, 0.0f, 3.0f);
+	camera.front = glm::vec3(0.0f, 0.0f, -1.0f);
+	camera.up = glm::vec3(0.0f, 1.0f, 0.0f);
+	camera.yaw = -90.0f;
+	camera.pitch = 0.0f;
+	camera.fov = 45.0f;
+	return world.create(camera, KeyboardMotion{2.5f},
+						MouseLook{0.1f, width / 2, height / 2, true});
+}
+
+glm::mat4
+cameraView(const Camera &camera)
+{
+	return glm::lookAt(camera.position, camera.position + camera.front,
+					   camera.up);
+}
+
+glm::vec3
+keyboardDirection(const InputState &input)
+{
+	glm::vec3 direction(0.0f);
+	if (input.held(GLFW_KEY_W))
+		direction.z += 1.0f;
+	if (input.held(GLFW_KEY_S))
+		direction.z -= 1.0f;
+	if (input.held(GLFW_KEY_A))
+		direction.x -= 1.0f;
+	if (input.held(GLFW_KEY_D))
+		direction.x += 1.0f;
+	return direction;
+}
+
+Camera
+interpolateCamera(const Camera &from, const Camera &to, float alpha)
+{
+	Camera camera = to;
+	camera.position = glm::mix(from.position, to.position, alpha);
+	camera.front = glm::normalize(glm::mix(from.front, to.front, alpha));
+	camera.up = glm::normalize(glm::mix(from.up, to.up, alpha));
+	camera.fov = glm::mix(from.fov, to.fov, alpha);
+	return camera;
+}
+
+void
+moveCameras(World &world, const glm::vec3 &direction, float deltaTime)
+{
+	if (direction == glm::vec3(0.0f))
+		return;
+
+	world.each<Camera, KeyboardMotion>(
+		[&](Entity, Camera &camera, KeyboardMotion &motion)
+		{
+			float distance = motion.speed * deltaTime;
+			glm::vec3 right =
+				glm::normalize(glm::cross(camera.front, camera.up));
+			camera.position += distance * direction.z * camera.front;
+			camera.position += distance * direction.x * right;
+		});
+}
+
+void
+lookCameras(World &world, double x, double y)
+{
+	world.each<Camera, MouseLook>([x, y](Entity, Camera &camera,
+										 MouseLook &look)
+								  { turnCamera(camera, look, x, y); });
+}
+
+Camera
+latchCamera(Camera camera, MouseLook look, double x, double y)
+{
+	// the snapshot already saw this position. turning anyway would replace
+	// the interpolated front with the one of the newest tick.
+	if (look.firstMouse || (float(x) == look.lastX && float(y) == look.lastY))
+		return camera;
+	turnCamera(camera, look, x, y);
+	return camera;
+}
+
+void
+zoomCameras(World &world, double offset)
+{
+	world.each<Camera>(
+		[offset](Entity, Camera &camera)
+		{ camera.fov = std::clamp(camera.fov - float(offset), 1.0f, 45.0f); });
+}
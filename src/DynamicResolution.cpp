@@ -0,0 +1,236 @@
+#include "DynamicResolution.hpp"
+#include "GLDebug.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+// render scales are multiples of this, smaller corrections are ignored.
+constexpr float scaleStep = 0.05f;
+// frames above the budget before scaling down.
+constexpr unsigned int overrunFrames = 3;
+// the frames have to stay below this part of the budget ...
+constexpr double growThreshold = 0.75;
+// ... for this many frames before scaling up a step.
+constexpr unsigned int growFrames = 60;
+// frames to wait after a change, the timer results lag a few frames.
+constexpr unsigned int settleFrames = 2 * FrameSync::maxFramesInFlight;
+
+} // namespace
+
+const char *
+upscaleModeName(UpscaleMode mode)
+{
+	switch (mode)
+	{
+		case UpscaleMode::Native:
+			return "native";
+		case UpscaleMode::Bilinear:
+			return "bilinear";
+		case UpscaleMode::Sharpen:
+			return "sharpen";
+	}
+	return "unknown";
+}
+
+bool
+parseUpscaleMode(const char *name, UpscaleMode &mode)
+{
+	for (UpscaleMode candidate :
+		 {UpscaleMode::Native, UpscaleMode::Bilinear, UpscaleMode::Sharpen})
+		if (std::strcmp(name, upscaleModeName(candidate)) == 0)
+		{
+			mode = candidate;
+			return true;
+		}
+	return false;
+}
+
+ResolutionController::ResolutionController(double budgetMs, float minScale)
+	: budgetMs(budgetMs), minScale(std::clamp(minScale, scaleStep, 1.0f))
+{
+}
+
+bool
+ResolutionController::update(double gpuMs)
+{
+	smoothedMs = smoothedMs == 0.0 ? gpuMs : 0.9 * smoothedMs + 0.1 * gpuMs;
+	if (cooldown != 0)
+	{
+		cooldown--;
+		return false;
+	}
+
+	overBudget = gpuMs > budgetMs ? overBudget + 1 : 0;
+	underBudget = smoothedMs < growThreshold * budgetMs ? underBudget + 1 : 0;
+
+	float next = current;
+	if (overBudget >= overrunFrames)
+	{
+		// aim a little below the budget, rounded down to a step.
+		float fit = current * std::sqrt(0.9 * budgetMs / gpuMs);
+		next = std::floor(fit / scaleStep) * scaleStep;
+		next = std::min(next, current - scaleStep);
+	}
+	else if (underBudget >= growFrames)
+		next = current + scaleStep;
+
+	next = std::clamp(next, minScale, maxScale);
+	if (std::abs(next - current) < scaleStep / 2)
+		return false;
+
+	current = next;
+	overBudget = underBudget = 0;
+	cooldown = settleFrames;
+	// the smoothed time belongs to the old scale.
+	smoothedMs = 0.0;
+	return true;
+}
+
+void
+ResolutionController::setMaxScale(float scale)
+{
+	maxScale = std::clamp(scale, minScale, 1.0f);
+	if (current > maxScale)
+	{
+		current = maxScale;
+		cooldown = settleFrames;
+		smoothedMs = 0.0;
+	}
+}
+
+DynamicResolution::DynamicResolution(const DynamicResolutionSettings &settings,
+									 const FrameSync &frames,
+									 const ShaderSource &upscale)
+	: settings(settings), controller(settings.budgetMs, settings.minScale),
+	  timer(frames)
+{
+	if (settings.upscale == UpscaleMode::Native)
+		return;
+
+	if (settings.upscale == UpscaleMode::Sharpen)
+	{
+		upscaleShader = std::make_unique<Shader>(upscale);
+		upscaleShader->use();
+		labelGLObject(GL_PROGRAM, upscaleShader->ID, "upscale");
+		upscaleShader->setInt("source", 0);
+		upscaleShader->setFloat("sharpness", settings.sharpness);
+		scaleLocation = upscaleShader->location("scale");
+		texelLocation = upscaleShader->location("texel");
+		// core profiles need a vertex array even without attributes.
+		glGenVertexArrays(1, &emptyVAO);
+	}
+	spdlog::info("Dynamic resolution: {} upscale, {:.2f} ms gpu budget, "
+				 "scale {:.2f} to 1",
+				 upscaleModeName(settings.upscale), settings.budgetMs,
+				 settings.minScale);
+}
+
+DynamicResolution::~DynamicResolution()
+{
+	if (framebuffer != 0)
+	{
+		glDeleteFramebuffers(1, &framebuffer);
+		glDeleteTextures(1, &color);
+		glDeleteRenderbuffers(1, &depth);
+	}
+	if (emptyVAO != 0)
+		glDeleteVertexArrays(1, &emptyVAO);
+}
+
+void
+DynamicResolution::allocate(int width, int height)
+{
+	if (framebuffer == 0)
+	{
+		glGenFramebuffers(1, &framebuffer);
+		glGenTextures(1, &color);
+		glGenRenderbuffers(1, &depth);
+	}
+	windowWidth = width;
+	windowHeight = height;
+
+	glBindTexture(GL_TEXTURE_2D, color);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA,
+				 GL_UNSIGNED_BYTE, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glBindRenderbuffer(GL_RENDERBUFFER, depth);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width,
+						  height);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D,
+						   color, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT,
+							  GL_RENDERBUFFER, depth);
+	labelGLObject(GL_FRAMEBUFFER, framebuffer, "scaled scene");
+	labelGLObject(GL_TEXTURE, color, "scaled scene color");
+	labelGLObject(GL_RENDERBUFFER, depth, "scaled scene depth");
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		spdlog::error("Scene framebuffer of {}x{} is incomplete", width,
+					  height);
+}
+
+void
+DynamicResolution::beginScene(int width, int height)
+{
+	if (timer.begin(gpuMs) && controller.update(gpuMs))
+		SPDLOG_DEBUG("Render scale {:.2f} after {:.2f} ms of gpu time",
+					 controller.scale(), gpuMs);
+
+	if (settings.upscale == UpscaleMode::Native)
+	{
+		sceneWidth = width;
+		sceneHeight = height;
+		glViewport(0, 0, width, height);
+		return;
+	}
+
+	if (width != windowWidth || height != windowHeight)
+		allocate(width, height);
+	sceneWidth = std::max(1, int(std::lround(width * controller.scale())));
+	sceneHeight = std::max(1, int(std::lround(height * controller.scale())));
+	glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+	glViewport(0, 0, sceneWidth, sceneHeight);
+}
+
+void
+DynamicResolution::endScene()
+{
+	timer.end();
+	if (settings.upscale == UpscaleMode::Native)
+		return;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	glViewport(0, 0, windowWidth, windowHeight);
+	if (settings.upscale == UpscaleMode::Bilinear)
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, framebuffer);
+		glBlitFramebuffer(0, 0, sceneWidth, sceneHeight, 0, 0, windowWidth,
+						  windowHeight, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+		return;
+	}
+
+	// every pixel is written, neither depth nor a clear is needed.
+	glDisable(GL_DEPTH_TEST);
+	upscaleShader->use();
+	upscaleShader->setVec2(scaleLocation,
+						   glm::vec2(float(sceneWidth) / windowWidth,
+									 float(sceneHeight) / windowHeight));
+	upscaleShader->setVec2(texelLocation,
+						   glm::vec2(1.0f / windowWidth, 1.0f / windowHeight));
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, color);
+	glBindVertexArray(emptyVAO);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glEnable(GL_DEPTH_TEST);
+}
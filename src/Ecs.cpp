@@ -0,0 +1,273 @@
+#include "Ecs.hpp"
+#include "TrackedAllocator.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <mutex>
+
+namespace
+{
+
+// chunks start on a cache line.
+constexpr std::size_t chunkAlignment = 64;
+
+TrackedAllocator &
+chunkAllocator()
+{
+	static TrackedAllocator &allocator = trackedAllocator("ecs");
+	return allocator;
+}
+
+// fixed storage, an entry never moves once its id was handed out, so
+// componentInfo() can read it without the lock from any thread.
+std::mutex registryLock;
+std::array<ComponentInfo, maxComponents> registry;
+std::size_t registeredCount = 0;
+
+std::size_t
+alignUp(std::size_t value, std::size_t align)
+{
+	return (value + align - 1) / align * align;
+}
+
+// column offsets for `capacity` entities, returns the bytes used.
+std::size_t
+layoutColumns(const std::vector<ComponentId> &components, uint32_t capacity,
+			  std::vector<std::size_t> &offsets)
+{
+	offsets.clear();
+	std::size_t end = capacity * sizeof(Entity);
+	for (ComponentId id : components)
+	{
+		const ComponentInfo &info = componentInfo(id);
+		std::size_t offset = alignUp(end, info.align);
+		offsets.push_back(offset);
+		end = offset + capacity * info.size;
+	}
+	return end;
+}
+
+} // namespace
+
+ComponentId
+registerComponent(std::size_t size, std::size_t align)
+{
+	std::lock_guard<std::mutex> lock(registryLock);
+	if (registeredCount == maxComponents)
+	{
+		spdlog::critical("More than {} component types", maxComponents);
+		std::abort();
+	}
+	registry[registeredCount] = {size, align};
+	return registeredCount++;
+}
+
+const ComponentInfo &
+componentInfo(ComponentId id)
+{
+	return registry[id];
+}
+
+Archetype::Archetype(const ComponentMask &mask) : mask(mask)
+{
+	std::fill(std::begin(columns), std::end(columns), -1);
+	for (ComponentId id = 0; id < maxComponents; id++)
+	{
+		if (!mask.test(id))
+			continue;
+		columns[id] = components.size();
+		components.push_back(id);
+	}
+
+	// the most entities whose columns still fit into one chunk.
+	std::size_t rowSize = sizeof(Entity);
+	for (ComponentId id : components)
+		rowSize += componentInfo(id).size;
+	capacity = std::max<std::size_t>(1, World::chunkSize / rowSize);
+	while (capacity > 1 &&
+		   layoutColumns(components, capacity, offsets) > World::chunkSize)
+		capacity--;
+	layoutColumns(components, capacity, offsets);
+}
+
+World::World()
+{
+	findArchetype(ComponentMask());
+}
+
+World::~World()
+{
+	for (const std::unique_ptr<Archetype> &archetype : archetypes)
+		for (const Chunk &chunk : archetype->chunks)
+			freeChunks.push_back(chunk.data);
+	for (unsigned char *chunk : freeChunks)
+		chunkAllocator().free(chunk);
+}
+
+void
+World::destroy(Entity entity)
+{
+	if (!alive(entity))
+		return;
+
+	Record &record = records[entity.index];
+	erase(record.archetype, record.chunk, record.row);
+	record.archetype = nullptr;
+	record.generation++;
+	freeIndices.push_back(entity.index);
+	liveEntities--;
+}
+
+bool
+World::alive(Entity entity) const
+{
+	return entity.index < records.size() &&
+		   records[entity.index].archetype != nullptr &&
+		   records[entity.index].generation == entity.generation;
+}
+
+std::size_t
+World::chunkCount() const
+{
+	std::size_t count = 0;
+	for (const std::unique_ptr<Archetype> &archetype : archetypes)
+		count += archetype->chunks.size();
+	return count;
+}
+
+bool
+World::has(Entity entity, ComponentId id) const
+{
+	return alive(entity) && records[entity.index].archetype->mask.test(id);
+}
+
+Entity
+World::entityOf(const Record &record) const
+{
+	const Chunk &chunk = record.archetype->chunks[record.chunk];
+	return record.archetype->entities(chunk)[record.row];
+}
+
+void *
+World::componentAt(const Record &record, ComponentId id) const
+{
+	const Archetype &archetype = *record.archetype;
+	return archetype.component(archetype.chunks[record.chunk],
+							   archetype.column(id), record.row);
+}
+
+uint32_t
+World::allocateEntity()
+{
+	liveEntities++;
+	if (!freeIndices.empty())
+	{
+		uint32_t index = freeIndices.back();
+		freeIndices.pop_back();
+		return index;
+	}
+	records.push_back({nullptr, 0, 0, 0});
+	return records.size() - 1;
+}
+
+Archetype *
+World::findArchetype(const ComponentMask &mask)
+{
+	auto found = archetypeByMask.find(mask);
+	if (found != archetypeByMask.end())
+		return found->second;
+
+	archetypes.push_back(std::make_unique<Archetype>(mask));
+	archetypeByMask[mask] = archetypes.back().get();
+	return archetypes.back().get();
+}
+
+World::Record &
+World::insert(Archetype *archetype, uint32_t index)
+{
+	std::vector<Chunk> &chunks = archetype->chunks;
+	if (chunks.empty() || chunks.back().count == archetype->capacity)
+	{
+		unsigned char *data;
+		if (!freeChunks.empty())
+		{
+			data = freeChunks.back();
+			freeChunks.pop_back();
+		}
+		else
+			data = static_cast<unsigned char *>(
+				chunkAllocator().allocate(chunkSize, chunkAlignment));
+		chunks.push_back({data, 0});
+	}
+
+	Chunk &chunk = chunks.back();
+	Record &record = records[index];
+	record.archetype = archetype;
+	record.chunk = chunks.size() - 1;
+	record.row = chunk.count++;
+	archetype->entities(chunk)[record.row] = {index, record.generation};
+	return record;
+}
+
+void
+World::erase(Archetype *archetype, uint32_t chunkIndex, uint32_t row)
+{
+	std::vector<Chunk> &chunks = archetype->chunks;
+	Chunk &chunk = chunks[chunkIndex];
+	Chunk &last = chunks.back();
+	uint32_t lastRow = last.count - 1;
+
+	if (&chunk != &last || row != lastRow)
+	{
+		Entity moved = archetype->entities(last)[lastRow];
+		archetype->entities(chunk)[row] = moved;
+		for (std::size_t column = 0; column < archetype->components.size();
+			 column++)
+			std::memcpy(archetype->component(chunk, column, row),
+						archetype->component(last, column, lastRow),
+						componentInfo(archetype->components[column]).size);
+		records[moved.index].chunk = chunkIndex;
+		records[moved.index].row = row;
+	}
+
+	if (--last.count == 0)
+	{
+		freeChunks.push_back(last.data);
+		chunks.pop_back();
+	}
+}
+
+void
+World::move(Entity entity, ComponentId id, bool adding)
+{
+	Record &record = records[entity.index];
+	Archetype *from = record.archetype;
+	auto &edges = adding ? from->addEdges : from->removeEdges;
+	auto edge = edges.find(id);
+	Archetype *to;
+	if (edge != edges.end())
+		to = edge->second;
+	else
+	{
+		ComponentMask mask = from->mask;
+		mask.set(id, adding);
+		to = findArchetype(mask);
+		edges[id] = to;
+	}
+
+	uint32_t chunkIndex = record.chunk, row = record.row;
+	insert(to, entity.index);
+	const Chunk &source = from->chunks[chunkIndex];
+	for (std::size_t column = 0; column < from->components.size(); column++)
+	{
+		ComponentId component = from->components[column];
+		if (component != id)
+			std::memcpy(componentAt(record, component),
+						from->component(source, column, row),
+						componentInfo(component).size);
+	}
+	erase(from, chunkIndex, row);
+}
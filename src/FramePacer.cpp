@@ -0,0 +1,185 @@
+#include "FramePacer.hpp"
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+
+using Clock = FramePacer::Clock;
+
+// bounds of the spin before a deadline. sleeping overshoots by tens of
+// microseconds on a quiet linux box and by a millisecond or more elsewhere.
+constexpr Clock::duration minSpin = std::chrono::microseconds(100);
+constexpr Clock::duration maxSpin = std::chrono::milliseconds(2);
+
+int
+swapInterval(VsyncMode mode)
+{
+	switch (mode)
+	{
+		case VsyncMode::Off:
+			return 0;
+		case VsyncMode::On:
+			return 1;
+		case VsyncMode::Adaptive:
+			break;
+	}
+	if (glfwExtensionSupported("WGL_EXT_swap_control_tear") ||
+		glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+		return -1;
+	spdlog::warn("Adaptive vsync is not supported, using vsync");
+	return 1;
+}
+
+} // namespace
+
+const char *
+vsyncModeName(VsyncMode mode)
+{
+	switch (mode)
+	{
+		case VsyncMode::Off:
+			return "off";
+		case VsyncMode::On:
+			return "on";
+		case VsyncMode::Adaptive:
+			return "adaptive";
+	}
+	return "unknown";
+}
+
+bool
+parseVsyncMode(const char *name, VsyncMode &mode)
+{
+	for (VsyncMode candidate :
+		 {VsyncMode::Off, VsyncMode::On, VsyncMode::Adaptive})
+		if (std::strcmp(name, vsyncModeName(candidate)) == 0)
+		{
+			mode = candidate;
+			return true;
+		}
+	return false;
+}
+
+FramePacer::FramePacer(const FramePacingSettings &settings)
+	: pacing(settings), deadline(Clock::now()), intervals(historySize, 0.0f),
+	  sorted(historySize)
+{
+	glfwSwapInterval(swapInterval(pacing.vsync));
+	if (pacing.targetRate > 0.0)
+		period = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(1.0 / pacing.targetRate));
+	spdlog::info("Frame pacing: vsync {}, {}", vsyncModeName(pacing.vsync),
+				 pacing.targetRate > 0.0
+					 ? fmt::format("limited to {:.0f} fps", pacing.targetRate)
+					 : std::string("no frame limit"));
+}
+
+void
+FramePacer::waitForNextFrame()
+{
+	if (period == Clock::duration::zero())
+		return;
+
+	deadline += period;
+	Clock::time_point now = Clock::now();
+	// more than a frame behind, start over instead of rushing to catch up.
+	if (now > deadline + period)
+	{
+		deadline = now;
+		return;
+	}
+
+	Clock::time_point wake = deadline - spinMargin;
+	if (now < wake)
+	{
+		std::this_thread::sleep_until(wake);
+		// keep the margin at twice the recent oversleep.
+		Clock::duration oversleep = Clock::now() - wake;
+		spinMargin = std::clamp((spinMargin * 7 + oversleep * 2) / 8, minSpin,
+								maxSpin);
+	}
+	while (Clock::now() < deadline)
+	{
+	}
+}
+
+void
+FramePacer::frameDone()
+{
+	Clock::time_point now = Clock::now();
+	if (swapped)
+	{
+		intervals[next] =
+			std::chrono::duration<float, std::milli>(now - lastSwap).count();
+		next = (next + 1) % historySize;
+		frames++;
+	}
+	lastSwap = now;
+	swapped = true;
+
+	if (pacing.reportEvery != 0 && frames != 0 &&
+		frames % pacing.reportEvery == 0)
+		report();
+}
+
+void
+FramePacer::resume()
+{
+	swapped = false;
+	deadline = Clock::now() - period;
+}
+
+FramePacingStats
+FramePacer::stats() const
+{
+	FramePacingStats stats;
+	stats.frames = std::min<uint64_t>(frames, historySize);
+	if (stats.frames == 0)
+		return stats;
+
+	sorted.assign(intervals.begin(), intervals.begin() + stats.frames);
+	std::sort(sorted.begin(), sorted.end());
+	double sum = 0.0, squares = 0.0;
+	for (float interval : sorted)
+	{
+		sum += interval;
+		squares += double(interval) * interval;
+	}
+	stats.mean = sum / stats.frames;
+	double variance = squares / stats.frames - stats.mean * stats.mean;
+	stats.stddev = std::sqrt(std::max(0.0, variance));
+	stats.min = sorted.front();
+	stats.max = sorted.back();
+	stats.p99 = sorted[std::min<std::size_t>(stats.frames - 1,
+											 stats.frames * 99 / 100)];
+
+	double expected =
+		pacing.targetRate > 0.0 ? 1000.0 / pacing.targetRate : stats.mean;
+	stats.late = sorted.end() - std::upper_bound(sorted.begin(), sorted.end(),
+												 1.5 * expected);
+	return stats;
+}
+
+void
+FramePacer::report() const
+{
+	FramePacingStats pacing = stats();
+	if (pacing.frames == 0)
+		return;
+	spdlog::info("Frame pacing over the last {} frames: {:.2f} ms mean "
+				 "({:.1f} fps), stddev {:.3f} ms, min {:.2f} max {:.2f} p99 "
+				 "{:.2f} ms, {} late",
+				 pacing.frames, pacing.mean, 1000.0 / pacing.mean,
+				 pacing.stddev, pacing.min, pacing.max, pacing.p99,
+				 pacing.late);
+}
@@ -0,0 +1,87 @@
+#include "FrameSync.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+
+namespace
+{
+
+// a single wait gives up after this long and warns, the loop keeps waiting.
+constexpr GLuint64 waitSliceNs = 100'000'000;
+
+} // namespace
+
+FrameSync::FrameSync(unsigned int framesInFlight)
+	: frames(std::clamp(framesInFlight, 1u, maxFramesInFlight))
+{
+	spdlog::info("Up to {} frames in flight", frames);
+}
+
+FrameSync::~FrameSync()
+{
+	for (GLsync fence : fences)
+		if (fence != nullptr)
+			glDeleteSync(fence);
+}
+
+void
+FrameSync::beginFrame()
+{
+	number++;
+	index = number % frames;
+
+	GLsync &fence = fences[index];
+	lastWait = 0.0;
+	if (fence == nullptr)
+		return;
+
+	using Clock = std::chrono::steady_clock;
+	Clock::time_point start = Clock::now();
+	// the first wait flushes, the fence may still sit in our command queue.
+	GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+	bool waited = false;
+	for (;;)
+	{
+		GLenum result = glClientWaitSync(fence, flags, waitSliceNs);
+		if (result == GL_ALREADY_SIGNALED || result == GL_WAIT_FAILED)
+		{
+			if (result == GL_WAIT_FAILED)
+				spdlog::error("Waiting for frame {} failed", number - frames);
+			break;
+		}
+		waited = true;
+		if (result == GL_CONDITION_SATISFIED)
+			break;
+		spdlog::warn("Frame {} still not finished by the gpu", number - frames);
+		flags = 0;
+	}
+	glDeleteSync(fence);
+	fence = nullptr;
+
+	if (!waited)
+		return;
+	lastWait = std::chrono::duration<double, std::milli>(Clock::now() - start)
+				   .count();
+	totalWait += lastWait;
+	maxWait = std::max(maxWait, lastWait);
+	waitedFrames++;
+	SPDLOG_DEBUG("Frame {} waited {:.3f} ms for the gpu", number, lastWait);
+}
+
+void
+FrameSync::endFrame()
+{
+	fences[index] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void
+FrameSync::report() const
+{
+	if (number == 0)
+		return;
+	spdlog::info("Frames in flight {}: {} of {} frames waited for the gpu, "
+				 "{:.3f} ms per frame on average, {:.3f} ms at most",
+				 frames, waitedFrames, number, totalWait / number, maxWait);
+}
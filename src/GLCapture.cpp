@@ -0,0 +1,83 @@
+#include "GLCapture.hpp"
+#include "GLInstrument.hpp"
+#include "GLTrace.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <string>
+
+// read by the instrumentation hooks on every call.
+GLTraceWriter *glCaptureWriter = nullptr;
+
+namespace
+{
+
+GLTraceWriter writer;
+std::string capturePath;
+unsigned int framesLeft = 0;
+unsigned int framesCaptured = 0;
+
+} // namespace
+
+bool
+startGLCapture(const char *path, unsigned int frames)
+{
+	if (!glInstrumentationInstalled() &&
+		!installGLInstrumentation(GLInstrumentSettings()))
+		return false;
+
+	stopGLCapture();
+	if (!writer.open(path))
+	{
+		spdlog::error("Failed to open GL capture file {}", path);
+		return false;
+	}
+
+	// the name table lets a replayer built from another glad still match.
+	writer.write("GLTR", 4);
+	writer.write(glTraceVersion);
+	writer.write(static_cast<uint32_t>(glFunctionCount));
+	for (const char *name : glFunctionNames)
+	{
+		uint16_t length = static_cast<uint16_t>(std::strlen(name));
+		writer.write(length);
+		writer.write(name, length);
+	}
+
+	capturePath = path;
+	framesLeft = frames;
+	framesCaptured = 0;
+	glCaptureWriter = &writer;
+	spdlog::info("Capturing {} frames of GL calls into {}", frames, path);
+	return true;
+}
+
+void
+endGLCaptureFrame()
+{
+	if (glCaptureWriter == nullptr)
+		return;
+
+	writer.write(glTraceFrameEnd);
+	framesCaptured++;
+	if (framesLeft != 0 && --framesLeft == 0)
+		stopGLCapture();
+}
+
+void
+stopGLCapture()
+{
+	if (glCaptureWriter == nullptr)
+		return;
+
+	glCaptureWriter = nullptr;
+	spdlog::info("GL capture {} done: {} frames, {:.1f} MiB", capturePath,
+				 framesCaptured, writer.bytesWritten() / (1024.0 * 1024.0));
+	writer.close();
+}
+
+bool
+glCaptureActive()
+{
+	return glCaptureWriter != nullptr;
+}
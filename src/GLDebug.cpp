@@ -0,0 +1,278 @@
+#include "GLDebug.hpp"
+#include "GLLoader.hpp"
+#include "Window.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+
+namespace
+{
+
+struct MessageType
+{
+	GLenum type;
+	const char *name;
+};
+
+const MessageType messageTypes[] = {
+	{GL_DEBUG_TYPE_ERROR, "error"},
+	{GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR, "deprecated"},
+	{GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR, "undefined behavior"},
+	{GL_DEBUG_TYPE_PORTABILITY, "portability"},
+	{GL_DEBUG_TYPE_PERFORMANCE, "performance"},
+	{GL_DEBUG_TYPE_MARKER, "marker"},
+	{GL_DEBUG_TYPE_PUSH_GROUP, "push group"},
+	{GL_DEBUG_TYPE_POP_GROUP, "pop group"},
+	{GL_DEBUG_TYPE_OTHER, "other"},
+};
+constexpr unsigned int typeCount =
+	sizeof(messageTypes) / sizeof(messageTypes[0]);
+
+const char *const severityNames[] = {"notification", "low", "medium", "high"};
+
+// the callback runs synchronously on the GL thread, like the frame
+// counters, so nothing here needs synchronization.
+bool installed = false;
+GLDebugSettings settings;
+GLDebugFrameStats frameStats, lastFrameStats;
+uint64_t typeTotals[typeCount];
+uint64_t suppressed = 0;
+// occurrences of every (source, type, id) in the current window, for the
+// rate limit. the counts start over every rateWindow.
+constexpr std::chrono::seconds rateWindow{1};
+std::unordered_map<uint64_t, uint32_t> seen;
+std::chrono::steady_clock::time_point windowStart;
+uint64_t windowSuppressed = 0;
+
+unsigned int
+typeIndex(GLenum type)
+{
+	for (unsigned int i = 0; i < typeCount; i++)
+		if (messageTypes[i].type == type)
+			return i;
+	return typeCount - 1; // other
+}
+
+GLDebugSeverity
+severityOf(GLenum severity)
+{
+	switch (severity)
+	{
+		case GL_DEBUG_SEVERITY_HIGH:
+			return GLDebugSeverity::High;
+		case GL_DEBUG_SEVERITY_MEDIUM:
+			return GLDebugSeverity::Medium;
+		case GL_DEBUG_SEVERITY_LOW:
+			return GLDebugSeverity::Low;
+		default:
+			return GLDebugSeverity::Notification;
+	}
+}
+
+const char *
+sourceName(GLenum source)
+{
+	switch (source)
+	{
+		case GL_DEBUG_SOURCE_API:
+			return "api";
+		case GL_DEBUG_SOURCE_WINDOW_SYSTEM:
+			return "window system";
+		case GL_DEBUG_SOURCE_SHADER_COMPILER:
+			return "shader compiler";
+		case GL_DEBUG_SOURCE_THIRD_PARTY:
+			return "third party";
+		case GL_DEBUG_SOURCE_APPLICATION:
+			return "application";
+		default:
+			return "other";
+	}
+}
+
+spdlog::level::level_enum
+logLevel(GLDebugSeverity severity)
+{
+	switch (severity)
+	{
+		case GLDebugSeverity::High:
+			return spdlog::level::err;
+		case GLDebugSeverity::Medium:
+			return spdlog::level::warn;
+		case GLDebugSeverity::Low:
+			return spdlog::level::info;
+		default:
+			return spdlog::level::debug;
+	}
+}
+
+void APIENTRY
+debugCallback(GLenum source, GLenum type, GLuint id, GLenum severity,
+			  GLsizei length, const GLchar *message, const void *)
+{
+	unsigned int index = typeIndex(type);
+	typeTotals[index]++;
+	frameStats.messages++;
+	if (type == GL_DEBUG_TYPE_PERFORMANCE)
+		frameStats.performance++;
+	else if (type == GL_DEBUG_TYPE_ERROR)
+		frameStats.errors++;
+
+	GLDebugSeverity level = severityOf(severity);
+	if (level < settings.logSeverity)
+		return;
+
+	uint64_t key = uint64_t(source & 0xffff) << 48 |
+				   uint64_t(type & 0xffff) << 32 | id;
+	uint32_t count = ++seen[key];
+	if (count > settings.repeats)
+	{
+		suppressed++;
+		windowSuppressed++;
+		return;
+	}
+
+	std::size_t size = length >= 0 ? std::size_t(length) : std::strlen(message);
+	spdlog::log(logLevel(level), "GL {} {} {}: {}{}", sourceName(source),
+				messageTypes[index].name, id,
+				fmt::string_view(message, size),
+				count == settings.repeats
+					? " (repeats are only counted this second)"
+					: "");
+}
+
+// a 4.1 context only gets the entry points from the extension, which glad
+// does not load for the 4.3 core version.
+void
+loadExtensionFunctions()
+{
+	if (glFunctionAvailable(id_glDebugMessageCallback) ||
+		!glfwExtensionSupported("GL_KHR_debug"))
+		return;
+	glad_glDebugMessageCallback = reinterpret_cast<PFNGLDEBUGMESSAGECALLBACKPROC>(
+		glfwGetProcAddress("glDebugMessageCallback"));
+	glad_glDebugMessageControl = reinterpret_cast<PFNGLDEBUGMESSAGECONTROLPROC>(
+		glfwGetProcAddress("glDebugMessageControl"));
+	glad_glObjectLabel = reinterpret_cast<PFNGLOBJECTLABELPROC>(
+		glfwGetProcAddress("glObjectLabel"));
+}
+
+} // namespace
+
+const char *
+glDebugSeverityName(GLDebugSeverity severity)
+{
+	return severityNames[static_cast<unsigned int>(severity)];
+}
+
+bool
+parseGLDebugSeverity(const char *name, GLDebugSeverity &severity)
+{
+	for (unsigned int i = 0; i < 4; i++)
+		if (std::strcmp(name, severityNames[i]) == 0)
+		{
+			severity = static_cast<GLDebugSeverity>(i);
+			return true;
+		}
+	return false;
+}
+
+bool
+installGLDebug(const GLDebugSettings &newSettings)
+{
+	settings = newSettings;
+	if (installed)
+		return true;
+
+	loadExtensionFunctions();
+	GLint flags = 0;
+	glGetIntegerv(GL_CONTEXT_FLAGS, &flags);
+	if ((flags & GL_CONTEXT_FLAG_DEBUG_BIT) == 0 ||
+		!glFunctionAvailable(id_glDebugMessageCallback))
+	{
+		spdlog::warn("GL debug output is not available, the context has no "
+					 "debug flag or no KHR_debug");
+		return false;
+	}
+
+	glEnable(GL_DEBUG_OUTPUT);
+	// slower, but every message is reported inside the call causing it.
+	glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+	glDebugMessageCallback(debugCallback, nullptr);
+	// low severity is off by default, many performance hints are low.
+	if (glFunctionAvailable(id_glDebugMessageControl))
+		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DONT_CARE, 0,
+							  nullptr, GL_TRUE);
+	installed = true;
+	windowStart = std::chrono::steady_clock::now();
+	spdlog::info("GL debug output installed, logging {} severity and up",
+				 glDebugSeverityName(settings.logSeverity));
+	return true;
+}
+
+bool
+glDebugInstalled()
+{
+	return installed;
+}
+
+void
+endGLDebugFrame()
+{
+	lastFrameStats = frameStats;
+	frameStats = GLDebugFrameStats();
+
+	if (!installed)
+		return;
+	std::chrono::steady_clock::time_point now =
+		std::chrono::steady_clock::now();
+	if (now - windowStart < rateWindow)
+		return;
+	if (windowSuppressed != 0)
+		spdlog::warn("GL debug output: {} repeated messages were only counted "
+					 "in the last {:.1f} s",
+					 windowSuppressed,
+					 std::chrono::duration<double>(now - windowStart).count());
+	// the keys stay, most messages come back in the next window.
+	for (auto &entry : seen)
+		entry.second = 0;
+	windowSuppressed = 0;
+	windowStart = now;
+}
+
+const GLDebugFrameStats &
+lastFrameGLDebugStats()
+{
+	return lastFrameStats;
+}
+
+void
+reportGLDebug()
+{
+	if (!installed)
+		return;
+
+	uint64_t total = 0;
+	for (uint64_t count : typeTotals)
+		total += count;
+	if (total == 0)
+	{
+		spdlog::info("GL debug output: no messages");
+		return;
+	}
+	spdlog::info("GL debug output: {} messages, {} kept from the log by the "
+				 "rate limit",
+				 total, suppressed);
+	for (unsigned int i = 0; i < typeCount; i++)
+		if (typeTotals[i] != 0)
+			spdlog::info("  {:<20} {:10}", messageTypes[i].name, typeTotals[i]);
+}
+
+void
+labelGLObject(GLenum identifier, GLuint name, const char *label)
+{
+	if (glFunctionAvailable(id_glObjectLabel))
+		glObjectLabel(identifier, name, -1, label);
+}
@@ -0,0 +1,7 @@
+#include "GLFunctions.hpp"
+
+const char *const glFunctionNames[glFunctionCount] = {
+#define GLAD_FUNCTION(name) #name,
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+};
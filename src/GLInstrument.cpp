@@ -0,0 +1,239 @@
+#include "GLInstrument.hpp"
+#include "GLFunctions.hpp"
+#include "GLTrace.hpp"
+
+#include <glad/glad.h>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef GLAD_INSTRUMENT
+
+namespace
+{
+
+struct CallCounters
+{
+	uint64_t calls;
+	uint64_t nanoseconds;
+};
+
+// GL is only ever called from the thread owning the context, so the
+// counters need no synchronization.
+CallCounters frameCounters[glFunctionCount];
+CallCounters totalCounters[glFunctionCount];
+uint64_t lastFrameCalls = 0;
+uint64_t frames = 0;
+bool installed = false;
+GLInstrumentSettings settings;
+
+class CallScope final
+{
+  public:
+	explicit CallScope(CallCounters &counters) : counters(counters)
+	{
+		counters.calls++;
+		if (settings.timeCalls)
+			start = std::chrono::steady_clock::now();
+	}
+
+	~CallScope()
+	{
+		if (settings.timeCalls)
+			counters.nanoseconds +=
+				std::chrono::duration_cast<std::chrono::nanoseconds>(
+					std::chrono::steady_clock::now() - start)
+					.count();
+	}
+
+  private:
+	CallCounters &counters;
+	std::chrono::steady_clock::time_point start;
+};
+
+template <unsigned int Id, typename Function> struct Hook;
+
+// one instantiation per entry point, holding the real driver function.
+template <unsigned int Id, typename R, typename... Args>
+struct Hook<Id, R(APIENTRYP)(Args...)>
+{
+	using Function = R(APIENTRYP)(Args...);
+
+	static Function real;
+
+	static R APIENTRY call(Args... args)
+	{
+		CallScope scope(frameCounters[Id]);
+		if (glCaptureWriter != nullptr)
+			return glTraceCapture<Id>(*glCaptureWriter, real, args...);
+		return real(args...);
+	}
+
+	static void install(Function &slot)
+	{
+		if (slot == nullptr || slot == &call)
+			return;
+		real = slot;
+		slot = &call;
+	}
+};
+
+template <unsigned int Id, typename R, typename... Args>
+typename Hook<Id, R(APIENTRYP)(Args...)>::Function
+	Hook<Id, R(APIENTRYP)(Args...)>::real = nullptr;
+
+} // namespace
+
+bool
+installGLInstrumentation(const GLInstrumentSettings &newSettings)
+{
+	settings = newSettings;
+	if (installed)
+		return true;
+
+#define GLAD_FUNCTION(name)                                                    \
+	Hook<id_##name, decltype(glad_##name)>::install(glad_##name);
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+
+	installed = true;
+	spdlog::info("GL instrumentation installed ({} entry points, timing {})",
+				 static_cast<unsigned int>(glFunctionCount),
+				 settings.timeCalls ? "on" : "off");
+	return true;
+}
+
+bool
+glInstrumentationInstalled()
+{
+	return installed;
+}
+
+void
+endGLInstrumentationFrame()
+{
+	if (!installed)
+		return;
+
+	lastFrameCalls = 0;
+	for (unsigned int id = 0; id < glFunctionCount; id++)
+	{
+		CallCounters &frame = frameCounters[id];
+		totalCounters[id].calls += frame.calls;
+		totalCounters[id].nanoseconds += frame.nanoseconds;
+		lastFrameCalls += frame.calls;
+		frame = CallCounters{};
+	}
+	frames++;
+
+	if (settings.reportEvery != 0 && frames % settings.reportEvery == 0)
+		reportGLInstrumentation();
+}
+
+std::vector<GLCallStat>
+topGLCalls(unsigned int count, GLCallOrder order)
+{
+	std::vector<unsigned int> ids;
+	for (unsigned int id = 0; id < glFunctionCount; id++)
+		if (totalCounters[id].calls != 0)
+			ids.push_back(id);
+
+	auto key = [order](unsigned int id)
+	{
+		return order == GLCallOrder::Calls ? totalCounters[id].calls
+										   : totalCounters[id].nanoseconds;
+	};
+	count = std::min<unsigned int>(count, ids.size());
+	std::partial_sort(ids.begin(), ids.begin() + count, ids.end(),
+					  [&](unsigned int a, unsigned int b)
+					  { return key(a) > key(b); });
+
+	std::vector<GLCallStat> stats;
+	double frameCount = std::max<uint64_t>(frames, 1);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const CallCounters &total = totalCounters[ids[i]];
+		stats.push_back({glFunctionNames[ids[i]], total.calls / frameCount,
+						 total.nanoseconds / 1e6 / frameCount});
+	}
+	return stats;
+}
+
+uint64_t
+lastFrameGLCalls()
+{
+	return lastFrameCalls;
+}
+
+void
+reportGLInstrumentation()
+{
+	if (!installed || frames == 0)
+		return;
+
+	uint64_t calls = 0, nanoseconds = 0;
+	for (const CallCounters &total : totalCounters)
+	{
+		calls += total.calls;
+		nanoseconds += total.nanoseconds;
+	}
+	spdlog::info("GL calls over {} frames: {:.1f} calls/frame{}", frames,
+				 static_cast<double>(calls) / frames,
+				 settings.timeCalls
+					 ? fmt::format(", {:.3f} ms/frame in the driver",
+								   nanoseconds / 1e6 / frames)
+					 : std::string());
+
+	GLCallOrder order =
+		settings.timeCalls ? GLCallOrder::Time : GLCallOrder::Calls;
+	for (const GLCallStat &stat : topGLCalls(settings.topN, order))
+	{
+		if (settings.timeCalls)
+			spdlog::info("  {:<32} {:10.1f} calls/frame {:9.3f} ms/frame",
+						 stat.name, stat.callsPerFrame, stat.msPerFrame);
+		else
+			spdlog::info("  {:<32} {:10.1f} calls/frame", stat.name,
+						 stat.callsPerFrame);
+	}
+}
+
+#else
+
+bool
+installGLInstrumentation(const GLInstrumentSettings &)
+{
+	spdlog::warn("GL instrumentation is not compiled in, configure with "
+				 "-DOPENGL_TUTORIAL_GL_INSTRUMENT=ON");
+	return false;
+}
+
+bool
+glInstrumentationInstalled()
+{
+	return false;
+}
+
+void
+endGLInstrumentationFrame()
+{
+}
+
+std::vector<GLCallStat>
+topGLCalls(unsigned int, GLCallOrder)
+{
+	return {};
+}
+
+uint64_t
+lastFrameGLCalls()
+{
+	return 0;
+}
+
+void
+reportGLInstrumentation()
+{
+}
+
+#endif
@@ -0,0 +1,258 @@
+#include "GLLoader.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+namespace
+{
+
+GLLoadMode loadMode = GLLoadMode::Full;
+GLADloadproc loader = nullptr;
+unsigned int resolvedCount = 0;
+
+// the first function of every version section, glad.h (and so the ids)
+// lists the functions of a version together, in version order.
+struct CoreVersion
+{
+	unsigned int first;
+	int major, minor;
+};
+
+const CoreVersion coreVersions[] = {
+	{id_glCullFace, 1, 0},
+	{id_glDrawArrays, 1, 1},
+	{id_glDrawRangeElements, 1, 2},
+	{id_glActiveTexture, 1, 3},
+	{id_glBlendFuncSeparate, 1, 4},
+	{id_glGenQueries, 1, 5},
+	{id_glBlendEquationSeparate, 2, 0},
+	{id_glUniformMatrix2x3fv, 2, 1},
+	{id_glColorMaski, 3, 0},
+	{id_glDrawArraysInstanced, 3, 1},
+	{id_glDrawElementsBaseVertex, 3, 2},
+	{id_glBindFragDataLocationIndexed, 3, 3},
+	{id_glMinSampleShading, 4, 0},
+	{id_glReleaseShaderCompiler, 4, 1},
+	{id_glDrawArraysInstancedBaseInstance, 4, 2},
+	{id_glClearBufferData, 4, 3},
+	{id_glBufferStorage, 4, 4},
+	{id_glClipControl, 4, 5},
+	{id_glSpecializeShader, 4, 6},
+};
+
+// true when the core version that introduced `id` is at most the one of
+// the context. the loader returns an address for any name, only these are
+// real, the same ones gladLoadGLLoader() loads.
+bool
+inContextVersion(unsigned int id)
+{
+	const CoreVersion *version = &coreVersions[0];
+	for (const CoreVersion &entry : coreVersions)
+		if (entry.first <= id)
+			version = &entry;
+	return GLVersion.major > version->major ||
+		   (GLVersion.major == version->major &&
+			GLVersion.minor >= version->minor);
+}
+
+template <unsigned int Id, typename Function> struct Trampoline;
+
+// one instantiation per entry point. `slot` is the glad pointer, it points
+// at call() until the first call resolved the function. hooks installed
+// over the trampoline (GLInstrument) stay in place, call() then forwards.
+template <unsigned int Id, typename R, typename... Args>
+struct Trampoline<Id, R(APIENTRYP)(Args...)>
+{
+	using Function = R(APIENTRYP)(Args...);
+
+	static Function *slot;
+	static Function resolved;
+	static bool missing;
+	static bool reported;
+
+	static R APIENTRY call(Args... args)
+	{
+		if (resolved == nullptr && !resolve())
+		{
+			if (!reported)
+				spdlog::error("{} is not available in this context",
+							  glFunctionNames[Id]);
+			reported = true;
+			if constexpr (!std::is_void_v<R>)
+				return R{};
+			else
+				return;
+		}
+		if (*slot == &call)
+			*slot = resolved;
+		return resolved(args...);
+	}
+
+	static bool resolve()
+	{
+		if (resolved != nullptr)
+			return true;
+		if (missing)
+			return false;
+		resolved = reinterpret_cast<Function>(loader(glFunctionNames[Id]));
+		if (resolved == nullptr)
+		{
+			missing = true;
+			return false;
+		}
+		resolvedCount++;
+		return true;
+	}
+
+	static void install(Function &function)
+	{
+		slot = &function;
+		function = &call;
+	}
+};
+
+template <unsigned int Id, typename R, typename... Args>
+typename Trampoline<Id, R(APIENTRYP)(Args...)>::Function
+	*Trampoline<Id, R(APIENTRYP)(Args...)>::slot = nullptr;
+template <unsigned int Id, typename R, typename... Args>
+typename Trampoline<Id, R(APIENTRYP)(Args...)>::Function
+	Trampoline<Id, R(APIENTRYP)(Args...)>::resolved = nullptr;
+template <unsigned int Id, typename R, typename... Args>
+bool Trampoline<Id, R(APIENTRYP)(Args...)>::missing = false;
+template <unsigned int Id, typename R, typename... Args>
+bool Trampoline<Id, R(APIENTRYP)(Args...)>::reported = false;
+
+// lazy mode: resolves a function of the context version now. the others,
+// and everything in full mode, are available when their pointer was
+// loaded, e.g. from an extension.
+using AvailableFunction = bool (*)();
+
+template <unsigned int Id, typename Function>
+bool
+available()
+{
+	using Entry = Trampoline<Id, Function>;
+	if (loadMode == GLLoadMode::Lazy && inContextVersion(Id))
+		return Entry::resolve();
+	return Entry::slot != nullptr && *Entry::slot != nullptr;
+}
+
+const AvailableFunction availableFunctions[glFunctionCount] = {
+#define GLAD_FUNCTION(name) &available<id_##name, decltype(glad_##name)>,
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+};
+
+// what glad's find_coreGL does, without the extension list.
+bool
+setVersionFlags()
+{
+	// only a current context can answer GL_VERSION.
+	PFNGLGETSTRINGPROC getString =
+		reinterpret_cast<PFNGLGETSTRINGPROC>(loader("glGetString"));
+	if (getString == nullptr)
+		return false;
+	const char *version =
+		reinterpret_cast<const char *>(getString(GL_VERSION));
+	int major = 0, minor = 0;
+	if (version == nullptr || std::sscanf(version, "%d.%d", &major, &minor) != 2)
+	{
+		spdlog::warn("Unknown GL version '{}'", version ? version : "");
+		return false;
+	}
+	GLVersion.major = major;
+	GLVersion.minor = minor;
+
+	auto at = [&](int flagMajor, int flagMinor)
+	{ return major > flagMajor || (major == flagMajor && minor >= flagMinor); };
+	GLAD_GL_VERSION_1_0 = at(1, 0);
+	GLAD_GL_VERSION_1_1 = at(1, 1);
+	GLAD_GL_VERSION_1_2 = at(1, 2);
+	GLAD_GL_VERSION_1_3 = at(1, 3);
+	GLAD_GL_VERSION_1_4 = at(1, 4);
+	GLAD_GL_VERSION_1_5 = at(1, 5);
+	GLAD_GL_VERSION_2_0 = at(2, 0);
+	GLAD_GL_VERSION_2_1 = at(2, 1);
+	GLAD_GL_VERSION_3_0 = at(3, 0);
+	GLAD_GL_VERSION_3_1 = at(3, 1);
+	GLAD_GL_VERSION_3_2 = at(3, 2);
+	GLAD_GL_VERSION_3_3 = at(3, 3);
+	GLAD_GL_VERSION_4_0 = at(4, 0);
+	GLAD_GL_VERSION_4_1 = at(4, 1);
+	GLAD_GL_VERSION_4_2 = at(4, 2);
+	GLAD_GL_VERSION_4_3 = at(4, 3);
+	GLAD_GL_VERSION_4_4 = at(4, 4);
+	GLAD_GL_VERSION_4_5 = at(4, 5);
+	GLAD_GL_VERSION_4_6 = at(4, 6);
+	return true;
+}
+
+} // namespace
+
+const char *
+glLoadModeName(GLLoadMode mode)
+{
+	return mode == GLLoadMode::Lazy ? "lazy" : "full";
+}
+
+bool
+parseGLLoadMode(const char *name, GLLoadMode &mode)
+{
+	if (std::strcmp(name, "full") == 0)
+		mode = GLLoadMode::Full;
+	else if (std::strcmp(name, "lazy") == 0)
+		mode = GLLoadMode::Lazy;
+	else
+		return false;
+	return true;
+}
+
+bool
+loadGL(GLLoadMode mode, GLADloadproc load)
+{
+	loadMode = mode;
+	loader = load;
+
+	// the slots are needed by glFunctionAvailable() in both modes.
+#define GLAD_FUNCTION(name)                                                    \
+	Trampoline<id_##name, decltype(glad_##name)>::slot = &glad_##name;
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+
+	if (mode == GLLoadMode::Full)
+	{
+		if (!gladLoadGLLoader(load))
+			return false;
+		resolvedCount = 0;
+		for (unsigned int id = 0; id < glFunctionCount; id++)
+			resolvedCount += availableFunctions[id]();
+		return true;
+	}
+
+	if (!setVersionFlags())
+		return false;
+	// past the context version the pointers stay null, as glad leaves them.
+#define GLAD_FUNCTION(name)                                                    \
+	if (inContextVersion(id_##name))                                           \
+		Trampoline<id_##name, decltype(glad_##name)>::install(glad_##name);    \
+	else                                                                       \
+		glad_##name = nullptr;
+#include <glad/glad_functions.h>
+#undef GLAD_FUNCTION
+	return true;
+}
+
+bool
+glFunctionAvailable(GLFunctionId id)
+{
+	return id < glFunctionCount && availableFunctions[id]();
+}
+
+unsigned int
+resolvedGLFunctionCount()
+{
+	return resolvedCount;
+}
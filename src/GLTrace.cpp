@@ -0,0 +1,609 @@
+#include "GLTrace.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+
+int32_t
+asInt(uint64_t value)
+{
+	return static_cast<int32_t>(static_cast<uint32_t>(value));
+}
+
+const void *
+asPointer(uint64_t value)
+{
+	return reinterpret_cast<const void *>(static_cast<uintptr_t>(value));
+}
+
+// what is known about the const pointer arguments of a function.
+struct PointerInfo
+{
+	enum Kind : uint8_t
+	{
+		Unknown, // stored as the pointer value after a warning.
+		Offset,	 // an offset into a bound buffer, stored as the value.
+		Sized,	 // `count` argument times `unit` bytes.
+		Pixels,	 // an image described by the other arguments.
+		Skip,	 // not needed for the replay, stored as null.
+	};
+	Kind kind = Unknown;
+	int8_t countIndex = -1;
+	uint32_t unit = 1;
+};
+
+uint32_t
+uniformUnit(const char *suffix)
+{
+	// f, i and ui are 4 bytes, d 8 bytes.
+	return suffix[0] == 'd' ? 8 : 4;
+}
+
+// fills in `info` for argument `index` of `name`, derived from the naming
+// rules of the GL api so every uniform / delete variant is covered.
+PointerInfo
+describePointer(unsigned int id, unsigned int index)
+{
+	const char *name = glFunctionNames[id];
+	PointerInfo info;
+	auto sized = [&](int countIndex, uint32_t unit)
+	{
+		info.kind = PointerInfo::Sized;
+		info.countIndex = static_cast<int8_t>(countIndex);
+		info.unit = unit;
+	};
+
+	// glUniform4fv(location, count, value),
+	// glUniformMatrix3x4fv(location, count, transpose, value), and the
+	// glProgramUniform forms with a leading program argument.
+	const char *uniform = nullptr;
+	int first = 0;
+	if (std::strncmp(name, "glUniform", 9) == 0)
+		uniform = name + 9;
+	else if (std::strncmp(name, "glProgramUniform", 16) == 0)
+	{
+		uniform = name + 16;
+		first = 1;
+	}
+	if (uniform != nullptr && name[std::strlen(name) - 1] == 'v')
+	{
+		if (std::strncmp(uniform, "Matrix", 6) == 0)
+		{
+			int columns = uniform[6] - '0';
+			int rows = uniform[7] == 'x' ? uniform[8] - '0' : columns;
+			const char *type = uniform + (uniform[7] == 'x' ? 9 : 7);
+			if (index == static_cast<unsigned int>(first + 3))
+				sized(first + 1, columns * rows * uniformUnit(type));
+		}
+		else if (uniform[0] >= '1' && uniform[0] <= '4' &&
+				 index == static_cast<unsigned int>(first + 2))
+			sized(first + 1, (uniform[0] - '0') * uniformUnit(uniform + 1));
+		return info;
+	}
+
+	// glDeleteBuffers(n, names) and friends.
+	if (std::strncmp(name, "glDelete", 8) == 0 &&
+		name[std::strlen(name) - 1] == 's' && index == 1)
+	{
+		sized(0, sizeof(GLuint));
+		return info;
+	}
+
+	if (std::strncmp(name, "glVertexAttrib", 14) == 0 &&
+		std::strstr(name, "Pointer") != nullptr)
+	{
+		info.kind = PointerInfo::Offset;
+		return info;
+	}
+	if (std::strncmp(name, "glDraw", 6) == 0 ||
+		std::strncmp(name, "glMultiDraw", 11) == 0)
+	{
+		// indices and indirect commands, expected in bound buffers.
+		info.kind = PointerInfo::Offset;
+		return info;
+	}
+
+	switch (id)
+	{
+		case id_glBufferData:
+		case id_glNamedBufferData:
+		case id_glBufferStorage:
+		case id_glNamedBufferStorage:
+			if (index == 2)
+				sized(1, 1);
+			break;
+		case id_glBufferSubData:
+		case id_glNamedBufferSubData:
+			if (index == 3)
+				sized(2, 1);
+			break;
+		case id_glCompressedTexImage2D:
+			if (index == 7)
+				sized(6, 1);
+			break;
+		case id_glCompressedTexSubImage2D:
+			if (index == 8)
+				sized(7, 1);
+			break;
+		case id_glDrawBuffers:
+			if (index == 1)
+				sized(0, sizeof(GLenum));
+			break;
+		case id_glInvalidateFramebuffer:
+			if (index == 2)
+				sized(1, sizeof(GLenum));
+			break;
+		case id_glTexImage1D:
+		case id_glTexSubImage1D:
+		case id_glTexImage2D:
+		case id_glTexSubImage2D:
+		case id_glTexImage3D:
+		case id_glTexSubImage3D:
+			info.kind = PointerInfo::Pixels;
+			break;
+		case id_glShaderSource:
+			// the strings are stored nul terminated, lengths are not needed.
+			if (index == 3)
+				info.kind = PointerInfo::Skip;
+			break;
+		default:
+			break;
+	}
+	return info;
+}
+
+uint32_t
+componentCount(GLenum format)
+{
+	switch (format)
+	{
+		case GL_RED:
+		case GL_GREEN:
+		case GL_BLUE:
+		case GL_RED_INTEGER:
+		case GL_DEPTH_COMPONENT:
+		case GL_STENCIL_INDEX:
+		case GL_DEPTH_STENCIL:
+			return 1;
+		case GL_RG:
+		case GL_RG_INTEGER:
+			return 2;
+		case GL_RGB:
+		case GL_BGR:
+		case GL_RGB_INTEGER:
+		case GL_BGR_INTEGER:
+			return 3;
+		default:
+			return 4;
+	}
+}
+
+uint32_t
+bytesPerPixel(GLenum format, GLenum type)
+{
+	switch (type)
+	{
+		case GL_UNSIGNED_BYTE:
+		case GL_BYTE:
+			return componentCount(format);
+		case GL_UNSIGNED_SHORT:
+		case GL_SHORT:
+		case GL_HALF_FLOAT:
+			return 2 * componentCount(format);
+		case GL_UNSIGNED_INT:
+		case GL_INT:
+		case GL_FLOAT:
+			return 4 * componentCount(format);
+		case GL_UNSIGNED_BYTE_3_3_2:
+		case GL_UNSIGNED_BYTE_2_3_3_REV:
+			return 1;
+		case GL_UNSIGNED_SHORT_5_6_5:
+		case GL_UNSIGNED_SHORT_5_6_5_REV:
+		case GL_UNSIGNED_SHORT_4_4_4_4:
+		case GL_UNSIGNED_SHORT_4_4_4_4_REV:
+		case GL_UNSIGNED_SHORT_5_5_5_1:
+		case GL_UNSIGNED_SHORT_1_5_5_5_REV:
+			return 2;
+		case GL_FLOAT_32_UNSIGNED_INT_24_8_REV:
+			return 8;
+		default: // the remaining packed formats are 32 bit.
+			return 4;
+	}
+}
+
+uint64_t
+pixelBytes(const GLTraceWriter &writer, unsigned int id,
+		   const uint64_t *values)
+{
+	// width, height, depth, format and type argument positions.
+	int w, h = -1, d = -1, format, type;
+	switch (id)
+	{
+		case id_glTexImage1D:
+			w = 3, format = 5, type = 6;
+			break;
+		case id_glTexSubImage1D:
+			w = 3, format = 4, type = 5;
+			break;
+		case id_glTexImage2D:
+			w = 3, h = 4, format = 6, type = 7;
+			break;
+		case id_glTexSubImage2D:
+			w = 4, h = 5, format = 6, type = 7;
+			break;
+		case id_glTexImage3D:
+			w = 3, h = 4, d = 5, format = 7, type = 8;
+			break;
+		default: // glTexSubImage3D
+			w = 5, h = 6, d = 7, format = 8, type = 9;
+			break;
+	}
+
+	uint64_t width = asInt(values[w]);
+	uint64_t height = h < 0 ? 1 : asInt(values[h]);
+	uint64_t depth = d < 0 ? 1 : asInt(values[d]);
+	if (width == 0 || height == 0 || depth == 0)
+		return 0;
+
+	uint64_t pixel = bytesPerPixel(static_cast<GLenum>(values[format]),
+								   static_cast<GLenum>(values[type]));
+	uint64_t rowLength =
+		writer.unpackRowLength > 0 ? writer.unpackRowLength : width;
+	uint64_t alignment = std::max(writer.unpackAlignment, 1);
+	uint64_t rowBytes = (rowLength * pixel + alignment - 1) / alignment *
+						alignment;
+	uint64_t imageHeight =
+		writer.unpackImageHeight > 0 ? writer.unpackImageHeight : height;
+	return rowBytes * imageHeight * (depth - 1) + rowBytes * (height - 1) +
+		   width * pixel;
+}
+
+} // namespace
+
+GLTraceWriter::~GLTraceWriter()
+{
+	close();
+}
+
+bool
+GLTraceWriter::open(const char *path)
+{
+	close();
+	file = std::fopen(path, "wb");
+	warned.assign(glFunctionCount, false);
+	bytes = 0;
+	return file != nullptr;
+}
+
+void
+GLTraceWriter::close()
+{
+	if (file == nullptr)
+		return;
+	std::fwrite(buffer.data(), 1, buffer.size(), file);
+	buffer.clear();
+	std::fclose(file);
+	file = nullptr;
+}
+
+void
+GLTraceWriter::write(const void *data, std::size_t size)
+{
+	const unsigned char *bytesIn = static_cast<const unsigned char *>(data);
+	buffer.insert(buffer.end(), bytesIn, bytesIn + size);
+	bytes += size;
+	if (buffer.size() >= (1u << 20) && file != nullptr)
+	{
+		std::fwrite(buffer.data(), 1, buffer.size(), file);
+		buffer.clear();
+	}
+}
+
+void
+GLTraceWriter::writeBlob(const void *data, uint32_t size)
+{
+	write(size);
+	if (size != 0)
+		write(data, size);
+}
+
+bool
+GLTraceReader::open(const char *path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file)
+		return false;
+	data.assign(std::istreambuf_iterator<char>(file),
+				std::istreambuf_iterator<char>());
+	position = 0;
+	return true;
+}
+
+const unsigned char *
+GLTraceReader::readBlob(uint32_t &size)
+{
+	size = read<uint32_t>();
+	const unsigned char *blob = data.data() + std::min(position, data.size());
+	position += size;
+	return position <= data.size() ? blob : nullptr;
+}
+
+void *
+GLReplayState::scratchFor(unsigned int index)
+{
+	// outputs such as glGetShaderInfoLog buffers or glGen names.
+	if (scratch.size() <= index)
+		scratch.resize(index + 1);
+	if (scratch[index].empty())
+		scratch[index].resize(8u << 20);
+	return scratch[index].data();
+}
+
+void
+glTraceBeforeCall(GLTraceWriter &writer, unsigned int id,
+				  const uint64_t *values)
+{
+	switch (id)
+	{
+		case id_glPixelStorei:
+			if (values[0] == GL_UNPACK_ALIGNMENT)
+				writer.unpackAlignment = asInt(values[1]);
+			else if (values[0] == GL_UNPACK_ROW_LENGTH)
+				writer.unpackRowLength = asInt(values[1]);
+			else if (values[0] == GL_UNPACK_IMAGE_HEIGHT)
+				writer.unpackImageHeight = asInt(values[1]);
+			break;
+		case id_glBindBuffer:
+			if (values[0] == GL_PIXEL_UNPACK_BUFFER)
+				writer.pixelUnpackBuffer = values[1] != 0;
+			break;
+		case id_glUnmapBuffer:
+		case id_glUnmapNamedBuffer:
+		{
+			// the application wrote into the mapping, which the hooks never
+			// see, so the whole range goes into the trace before the unmap.
+			GLenum key = static_cast<GLenum>(values[0]);
+			auto found = writer.mappings.find(key);
+			if (found == writer.mappings.end())
+				break;
+			writer.write(glTraceMapWrite);
+			writer.write(static_cast<uint32_t>(key));
+			writer.writeBlob(found->second.pointer,
+							 static_cast<uint32_t>(found->second.length));
+			writer.mappings.erase(found);
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+void
+glTraceAfterCall(GLTraceWriter &writer, unsigned int id,
+				 const uint64_t *values, uint64_t result)
+{
+	switch (id)
+	{
+		case id_glMapBufferRange:
+		case id_glMapNamedBufferRange:
+			if (result != 0 && (values[3] & GL_MAP_WRITE_BIT))
+				writer.mappings[static_cast<GLenum>(values[0])] = {
+					const_cast<void *>(asPointer(result)),
+					static_cast<GLsizeiptr>(values[2])};
+			break;
+		case id_glMapBuffer:
+		case id_glMapNamedBuffer:
+			if (!writer.warned[id])
+			{
+				spdlog::warn("GL capture: {} is not supported, use "
+							 "glMapBufferRange",
+							 glFunctionNames[id]);
+				writer.warned[id] = true;
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+void
+glTraceEncodeInput(GLTraceWriter &writer, unsigned int id, unsigned int index,
+				   const void *pointer, const uint64_t *values)
+{
+	PointerInfo info = describePointer(id, index);
+	if (pointer == nullptr || info.kind == PointerInfo::Skip)
+	{
+		writer.write(GLTraceNull);
+		return;
+	}
+
+	uint64_t size = 0;
+	switch (info.kind)
+	{
+		case PointerInfo::Sized:
+			// byte sizes are GLsizeiptr, element counts GLsizei.
+			size = info.unit == 1
+					   ? values[info.countIndex]
+					   : static_cast<uint64_t>(asInt(values[info.countIndex])) *
+							 info.unit;
+			break;
+		case PointerInfo::Pixels:
+			if (writer.pixelUnpackBuffer)
+				info.kind = PointerInfo::Offset;
+			else
+				size = pixelBytes(writer, id, values);
+			break;
+		case PointerInfo::Unknown:
+			if (!writer.warned[id])
+			{
+				spdlog::warn("GL capture: size of argument {} of {} unknown, "
+							 "recorded as a buffer offset",
+							 index, glFunctionNames[id]);
+				writer.warned[id] = true;
+			}
+			break;
+		default:
+			break;
+	}
+
+	if (info.kind == PointerInfo::Sized || info.kind == PointerInfo::Pixels)
+	{
+		writer.write(GLTraceData);
+		writer.writeBlob(pointer, static_cast<uint32_t>(size));
+	}
+	else
+	{
+		writer.write(GLTraceValue);
+		writer.write(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pointer)));
+	}
+}
+
+void
+glTraceEncodeString(GLTraceWriter &writer, const GLchar *string)
+{
+	if (string == nullptr)
+	{
+		writer.write(GLTraceNull);
+		return;
+	}
+	writer.write(GLTraceData);
+	writer.writeBlob(string, static_cast<uint32_t>(std::strlen(string) + 1));
+}
+
+void
+glTraceEncodeStrings(GLTraceWriter &writer, unsigned int id,
+					 const GLchar *const *strings, const uint64_t *values)
+{
+	// every function taking a string list has the count as argument 1.
+	uint32_t count = static_cast<uint32_t>(asInt(values[1]));
+	const GLint *lengths = nullptr;
+	if (id == id_glShaderSource)
+		lengths = static_cast<const GLint *>(asPointer(values[3]));
+
+	writer.write(count);
+	std::string copy;
+	for (uint32_t i = 0; i < count; i++)
+	{
+		if (lengths != nullptr && lengths[i] >= 0)
+			copy.assign(strings[i], lengths[i]);
+		else
+			copy.assign(strings[i]);
+		writer.writeBlob(copy.c_str(), static_cast<uint32_t>(copy.size() + 1));
+	}
+}
+
+unsigned int
+glTraceOutputNames(unsigned int id, const uint64_t *values,
+				   unsigned int &index)
+{
+	const char *name = glFunctionNames[id];
+	if (std::strncmp(name, "glGen", 5) == 0 &&
+		std::strncmp(name, "glGenerate", 10) != 0)
+	{
+		index = 1;
+		return asInt(values[0]);
+	}
+
+	switch (id)
+	{
+		case id_glCreateBuffers:
+		case id_glCreateVertexArrays:
+		case id_glCreateFramebuffers:
+		case id_glCreateRenderbuffers:
+		case id_glCreateSamplers:
+		case id_glCreateTransformFeedbacks:
+		case id_glCreateProgramPipelines:
+			index = 1;
+			return asInt(values[0]);
+		case id_glCreateTextures:
+		case id_glCreateQueries:
+			index = 2;
+			return asInt(values[1]);
+		default:
+			return 0;
+	}
+}
+
+const void *
+glTraceDecodeInput(GLTraceReader &reader)
+{
+	switch (reader.read<uint8_t>())
+	{
+		case GLTraceValue:
+			return asPointer(reader.read<uint64_t>());
+		case GLTraceData:
+		{
+			uint32_t size;
+			return reader.readBlob(size);
+		}
+		default:
+			return nullptr;
+	}
+}
+
+const GLchar *const *
+glTraceDecodeStrings(GLTraceReader &reader, GLReplayState &state)
+{
+	uint32_t count = reader.read<uint32_t>();
+	state.strings.clear();
+	for (uint32_t i = 0; i < count && !reader.failed(); i++)
+	{
+		uint32_t size;
+		state.strings.push_back(
+			reinterpret_cast<const GLchar *>(reader.readBlob(size)));
+	}
+	return state.strings.data();
+}
+
+void
+glTraceCheckNames(GLTraceReader &reader, GLReplayState &state,
+				  unsigned int id, const void *names, unsigned int count)
+{
+	uint32_t size;
+	const unsigned char *captured = reader.readBlob(size);
+	if (captured == nullptr || size != count * sizeof(GLuint) ||
+		std::memcmp(captured, names, size) == 0)
+		return;
+
+	if (state.mismatches++ == 0)
+		spdlog::warn("GL replay: {} returned other object names than in the "
+					 "capture, the replay may draw the wrong objects",
+					 glFunctionNames[id]);
+}
+
+void
+glTraceMissing(GLReplayState &state, unsigned int id)
+{
+	if (state.missing.empty())
+		state.missing.assign(glFunctionCount, false);
+	if (state.missing[id])
+		return;
+	state.missing[id] = true;
+	spdlog::warn("GL replay: {} is not available in this context, skipped",
+				 glFunctionNames[id]);
+}
+
+void
+glTraceCheckResult(GLReplayState &state, unsigned int id, uint64_t captured,
+				   uint64_t replayed)
+{
+	switch (id)
+	{
+		case id_glCreateShader:
+		case id_glCreateProgram:
+		case id_glGetUniformLocation:
+		case id_glGetAttribLocation:
+		case id_glGetUniformBlockIndex:
+			break;
+		default:
+			return;
+	}
+	if (captured != replayed && state.mismatches++ == 0)
+		spdlog::warn("GL replay: {} returned {} instead of {} as captured",
+					 glFunctionNames[id], asInt(replayed), asInt(captured));
+}
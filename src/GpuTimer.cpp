@@ -0,0 +1,40 @@
+#include "GpuTimer.hpp"
+
+GpuTimer::GpuTimer(const FrameSync &frames) : frames(frames)
+{
+	glGenQueries(FrameSync::maxFramesInFlight, queries);
+}
+
+GpuTimer::~GpuTimer()
+{
+	glDeleteQueries(FrameSync::maxFramesInFlight, queries);
+}
+
+bool
+GpuTimer::begin(double &previousMs)
+{
+	unsigned int slot = frames.frameIndex();
+	bool available = false;
+	if (issued[slot])
+	{
+		GLint ready = GL_FALSE;
+		glGetQueryObjectiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &ready);
+		if (ready == GL_TRUE)
+		{
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &nanoseconds);
+			previousMs = nanoseconds / 1e6;
+			available = true;
+		}
+	}
+	// an unread result is overwritten, a lost sample only.
+	glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+	issued[slot] = true;
+	return available;
+}
+
+void
+GpuTimer::end()
+{
+	glEndQuery(GL_TIME_ELAPSED);
+}
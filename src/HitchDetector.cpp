@@ -0,0 +1,208 @@
+#include "HitchDetector.hpp"
+#include "AllocationCounter.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+
+HitchDetector::HitchDetector(const HitchSettings &settings, JobSystem &jobs)
+	: settings(settings), jobs(jobs), created(Clock::now())
+{
+	if (!enabled())
+		return;
+	this->settings.history = std::max(this->settings.history, warmupFrames);
+	records.resize(this->settings.history);
+	sorted.resize(this->settings.history);
+	snapshot.reserve(this->settings.history);
+	current.zoneCount = 0;
+	spdlog::info("Hitch detector: frames over {:.1f}x the median are traced "
+				 "to {}",
+				 settings.factor, settings.directory);
+}
+
+HitchDetector::~HitchDetector()
+{
+	jobs.wait(writes);
+}
+
+float
+HitchDetector::sinceFrameStart(Clock::time_point time) const
+{
+	return std::chrono::duration<float, std::milli>(time - frameStart).count();
+}
+
+void
+HitchDetector::closeZone(Clock::time_point now)
+{
+	if (current.zoneCount == 0)
+		return;
+	Zone &last = current.zones[current.zoneCount - 1];
+	last.durationMs = sinceFrameStart(now) - last.startMs;
+}
+
+void
+HitchDetector::zone(const char *name)
+{
+	if (!enabled() || !started)
+		return;
+	Clock::time_point now = Clock::now();
+	closeZone(now);
+	// past the last slot the phases are folded into the last zone.
+	if (current.zoneCount == maxZones)
+		return;
+	current.zones[current.zoneCount++] = {name, sinceFrameStart(now), 0.0f};
+}
+
+void
+HitchDetector::endFrame(const HitchCounters &counters)
+{
+	if (!enabled())
+		return;
+	Clock::time_point now = Clock::now();
+	uint64_t allocations = heapAllocationCount();
+	if (started)
+	{
+		closeZone(now);
+		current.frame = frames;
+		current.startMs =
+			std::chrono::duration<double, std::milli>(frameStart - created)
+				.count();
+		current.frameMs = sinceFrameStart(now);
+		current.gpuMs = static_cast<float>(counters.gpuMs);
+		current.allocations =
+			static_cast<uint32_t>(allocations - allocationsAtStart);
+		current.uploadBytes = counters.uploadBytes;
+		current.drawCalls = counters.drawCalls;
+		current.glPerformanceMessages = counters.glPerformanceMessages;
+		records[next] = current;
+		next = (next + 1) % records.size();
+		frames++;
+
+		if (frames >= warmupFrames && frames >= quietUntil)
+		{
+			float median = medianFrameMs();
+			if (current.frameMs > settings.factor * median)
+				dump(median);
+		}
+	}
+
+	started = true;
+	frameStart = now;
+	allocationsAtStart = allocations;
+	current.zoneCount = 0;
+}
+
+void
+HitchDetector::resume()
+{
+	started = false;
+	current.zoneCount = 0;
+}
+
+float
+HitchDetector::medianFrameMs()
+{
+	std::size_t count = std::min<uint64_t>(frames, records.size());
+	for (std::size_t i = 0; i < count; i++)
+		sorted[i] = records[i].frameMs;
+	std::nth_element(sorted.begin(), sorted.begin() + count / 2,
+					 sorted.begin() + count);
+	return sorted[count / 2];
+}
+
+void
+HitchDetector::dump(float medianMs)
+{
+	hitches++;
+	// the frames after the spike are not worth a trace of their own.
+	quietUntil = frames + records.size() / 2;
+	if (writing.load(std::memory_order_acquire))
+	{
+		spdlog::warn("Frame {} took {:.1f} ms ({:.1f}x the median), the "
+					 "previous trace is still being written",
+					 current.frame, current.frameMs, current.frameMs / medianMs);
+		return;
+	}
+
+	// oldest frame first.
+	snapshot.clear();
+	std::size_t count = std::min<uint64_t>(frames, records.size());
+	std::size_t first = count < records.size() ? 0 : next;
+	for (std::size_t i = 0; i < count; i++)
+		snapshot.push_back(records[(first + i) % records.size()]);
+
+	writing.store(true, std::memory_order_release);
+	// without workers a queued write would wait for the next jobs.wait(),
+	// keeping `writing` set until then, so the frame pays for it instead.
+	if (jobs.workerCount() == 0)
+		write(medianMs);
+	else
+		jobs.run([this, medianMs]() { write(medianMs); }, &writes);
+}
+
+void
+HitchDetector::write(float medianMs)
+{
+	const Record &hitch = snapshot.back();
+	std::string path = fmt::format("{}/hitch-{}.json", settings.directory,
+								   hitch.frame);
+
+	// chrome trace events, times in microseconds. the zones nest inside
+	// their frame on the same track, the counters get tracks of their own.
+	fmt::memory_buffer out;
+	fmt::format_to(std::back_inserter(out),
+				   "{{\"displayTimeUnit\":\"ms\",\"otherData\":{{\"frame\":{},"
+				   "\"frameMs\":{:.3f},\"medianMs\":{:.3f}}},\"traceEvents\":[",
+				   hitch.frame, hitch.frameMs, medianMs);
+	const char *separator = "";
+	for (const Record &record : snapshot)
+	{
+		double start = record.startMs * 1000.0;
+		fmt::format_to(std::back_inserter(out),
+					   "{}\n{{\"name\":\"frame {}\",\"ph\":\"X\",\"pid\":1,"
+					   "\"tid\":1,\"ts\":{:.1f},\"dur\":{:.1f},\"args\":{{"
+					   "\"gpuMs\":{:.3f},\"allocations\":{},\"uploadBytes\":{},"
+					   "\"drawCalls\":{},\"glPerformanceMessages\":{}}}}}",
+					   separator, record.frame, start, record.frameMs * 1000.0,
+					   record.gpuMs, record.allocations, record.uploadBytes,
+					   record.drawCalls, record.glPerformanceMessages);
+		separator = ",";
+		for (unsigned int z = 0; z < record.zoneCount; z++)
+		{
+			const Zone &zone = record.zones[z];
+			fmt::format_to(std::back_inserter(out),
+						   ",\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,"
+						   "\"tid\":1,\"ts\":{:.1f},\"dur\":{:.1f}}}",
+						   zone.name, start + zone.startMs * 1000.0,
+						   zone.durationMs * 1000.0);
+		}
+		fmt::format_to(std::back_inserter(out),
+					   ",\n{{\"name\":\"gpu ms\",\"ph\":\"C\",\"pid\":1,"
+					   "\"ts\":{:.1f},\"args\":{{\"value\":{:.3f}}}}}"
+					   ",\n{{\"name\":\"allocations\",\"ph\":\"C\",\"pid\":1,"
+					   "\"ts\":{:.1f},\"args\":{{\"value\":{}}}}}"
+					   ",\n{{\"name\":\"upload bytes\",\"ph\":\"C\",\"pid\":1,"
+					   "\"ts\":{:.1f},\"args\":{{\"value\":{}}}}}",
+					   start, record.gpuMs, start, record.allocations, start,
+					   record.uploadBytes);
+	}
+	fmt::format_to(std::back_inserter(out), "\n]}}\n");
+
+	FILE *file = std::fopen(path.c_str(), "wb");
+	bool ok = file != nullptr &&
+			  std::fwrite(out.data(), 1, out.size(), file) == out.size();
+	if (file != nullptr)
+		ok = std::fclose(file) == 0 && ok;
+	if (ok)
+		spdlog::warn("Frame {} took {:.1f} ms ({:.1f}x the median), the last "
+					 "{} frames are in {}",
+					 hitch.frame, hitch.frameMs, hitch.frameMs / medianMs,
+					 snapshot.size(), path);
+	else
+		spdlog::error("Frame {} took {:.1f} ms, failed to write {}",
+					  hitch.frame, hitch.frameMs, path);
+
+	writing.store(false, std::memory_order_release);
+}
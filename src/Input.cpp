@@ -0,0 +1,108 @@
+#include "Input.hpp"
+
+namespace
+{
+
+InputQueue &
+queueOf(GLFWwindow *window)
+{
+	return *static_cast<InputQueue *>(glfwGetWindowUserPointer(window));
+}
+
+void
+keyCallback(GLFWwindow *window, int key, int, int action, int)
+{
+	if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+	// key repeats change nothing, unknown keys have no code.
+	if (key < 0 || action == GLFW_REPEAT)
+		return;
+	queueOf(window).push({action == GLFW_PRESS ? InputEvent::KeyDown
+											   : InputEvent::KeyUp,
+						  key, 0.0, 0.0, std::chrono::steady_clock::now()});
+}
+
+void
+cursorCallback(GLFWwindow *window, double x, double y)
+{
+	queueOf(window).push(
+		{InputEvent::CursorMove, 0, x, y, std::chrono::steady_clock::now()});
+}
+
+void
+scrollCallback(GLFWwindow *window, double x, double y)
+{
+	queueOf(window).push(
+		{InputEvent::Scroll, 0, x, y, std::chrono::steady_clock::now()});
+}
+
+} // namespace
+
+void
+InputQueue::push(const InputEvent &event)
+{
+	pushed++;
+	if (event.type == InputEvent::CursorMove)
+	{
+		cursorKnown = true;
+		cursorX = event.x;
+		cursorY = event.y;
+	}
+	if (!pendingTimes)
+		firstTime = event.time;
+	lastTime = event.time;
+	pendingTimes = true;
+
+	bool key = event.type == InputEvent::KeyDown ||
+			   event.type == InputEvent::KeyUp;
+	if (!events.push(event, key ? 0 : keyReserve))
+		dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool
+InputQueue::takeEventTimes(std::chrono::steady_clock::time_point &first,
+						   std::chrono::steady_clock::time_point &last)
+{
+	if (!pendingTimes)
+		return false;
+	first = firstTime;
+	last = lastTime;
+	pendingTimes = false;
+	return true;
+}
+
+void
+installInputCallbacks(GLFWwindow *window, InputQueue &queue)
+{
+	glfwSetWindowUserPointer(window, &queue);
+	glfwSetKeyCallback(window, keyCallback);
+	glfwSetCursorPosCallback(window, cursorCallback);
+	glfwSetScrollCallback(window, scrollCallback);
+}
+
+void
+drainInput(InputQueue &queue, InputState &state)
+{
+	state.cursorMoved = false;
+	state.scroll = 0.0;
+
+	InputEvent event;
+	while (queue.pop(event))
+	{
+		switch (event.type)
+		{
+			case InputEvent::KeyDown:
+			case InputEvent::KeyUp:
+				state.keys[event.key] = event.type == InputEvent::KeyDown;
+				break;
+			case InputEvent::CursorMove:
+				state.cursorMoved = true;
+				state.cursorX = event.x;
+				state.cursorY = event.y;
+				break;
+			case InputEvent::Scroll:
+				state.scroll += event.y;
+				break;
+		}
+	}
+}
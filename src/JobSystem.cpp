@@ -0,0 +1,304 @@
+#include "JobSystem.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdlib>
+
+namespace
+{
+
+thread_local unsigned int currentThread = JobSystem::notOwned;
+
+// failed steal attempts before a worker goes to sleep.
+constexpr unsigned int spinRounds = 64;
+
+} // namespace
+
+Job *
+JobPool::allocate()
+{
+	if (freeJobs == nullptr)
+		freeJobs = releasedJobs.exchange(nullptr, std::memory_order_acquire);
+	if (freeJobs == nullptr)
+	{
+		blocks.emplace_back(new Job[blockSize]);
+		Job *block = blocks.back().get();
+		for (std::size_t i = 0; i < blockSize; i++)
+		{
+			block[i].pool = this;
+			block[i].next = i + 1 < blockSize ? &block[i + 1] : nullptr;
+		}
+		freeJobs = block;
+	}
+
+	Job *job = freeJobs;
+	freeJobs = job->next;
+	job->next = nullptr;
+	return job;
+}
+
+void
+JobPool::release(Job *job)
+{
+	// only the owner takes jobs out, and it takes all of them at once, so
+	// the push cannot suffer from ABA.
+	Job *head = releasedJobs.load(std::memory_order_relaxed);
+	do
+		job->next = head;
+	while (!releasedJobs.compare_exchange_weak(head, job,
+											   std::memory_order_release,
+											   std::memory_order_relaxed));
+}
+
+bool
+JobDeque::push(Job *job)
+{
+	int64_t b = bottom.load(std::memory_order_relaxed);
+	int64_t t = top.load(std::memory_order_acquire);
+	if (b - t >= capacity)
+		return false;
+	jobs[b & (capacity - 1)].store(job, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+Job *
+JobDeque::pop()
+{
+	int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t t = top.load(std::memory_order_relaxed);
+
+	if (t > b)
+	{
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	Job *job = jobs[b & (capacity - 1)].load(std::memory_order_relaxed);
+	if (t == b)
+	{
+		// the last job, a thief may be taking it at the same time.
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+										 std::memory_order_relaxed))
+			job = nullptr;
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+Job *
+JobDeque::steal()
+{
+	int64_t t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64_t b = bottom.load(std::memory_order_acquire);
+	if (t >= b)
+		return nullptr;
+
+	Job *job = jobs[t & (capacity - 1)].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+									 std::memory_order_relaxed))
+		return nullptr;
+	return job;
+}
+
+JobSystem::JobSystem(unsigned int workerCount)
+{
+	if (workerCount == 0)
+		workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+
+	currentThread = 0;
+	for (unsigned int i = 0; i <= workerCount; i++)
+		threads.push_back(std::make_unique<Thread>());
+	for (unsigned int i = 1; i <= workerCount; i++)
+		workers.emplace_back(&JobSystem::workerMain, this, i);
+	spdlog::info("Job system started with {} workers", workerCount);
+}
+
+JobSystem::~JobSystem()
+{
+	running.store(false);
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		wakeUp.notify_all();
+	}
+	for (std::thread &worker : workers)
+		worker.join();
+
+	drainMainThread();
+}
+
+unsigned int
+JobSystem::threadIndex()
+{
+	return currentThread;
+}
+
+JobSystem::Thread &
+JobSystem::ownThread()
+{
+	unsigned int index = threadIndex();
+	if (index >= threads.size())
+	{
+		spdlog::critical("Jobs scheduled from a thread the job system does "
+						 "not own");
+		std::abort();
+	}
+	return *threads[index];
+}
+
+void
+JobSystem::wait(JobCounter &counter)
+{
+	ownThread();
+	unsigned int index = threadIndex();
+	while (!counter.done())
+	{
+		if (Job *job = findJob(index))
+			execute(job);
+		else
+			std::this_thread::yield();
+	}
+	// the last job may still be holding the lock, see execute().
+	std::lock_guard<std::mutex> lock(counter.continuationLock);
+}
+
+void
+JobSystem::drainMainThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(mainThreadLock);
+		drainingJobs.swap(mainThreadJobs);
+	}
+	for (Job *job : drainingJobs)
+		execute(job);
+	drainingJobs.clear();
+}
+
+void
+JobSystem::schedule(Job *job)
+{
+	// without workers nothing but a wait() would run a queued job.
+	if (workers.empty() || !ownThread().deque.push(job))
+	{
+		execute(job);
+		return;
+	}
+	// pairs with the sleeping increment in workerMain(): either this sees
+	// the sleeper, or the sleeper sees the new push count.
+	pushes.fetch_add(1, std::memory_order_seq_cst);
+	if (sleeping.load(std::memory_order_seq_cst) != 0)
+	{
+		std::lock_guard<std::mutex> lock(sleepLock);
+		wakeUp.notify_one();
+	}
+}
+
+void
+JobSystem::scheduleAfter(JobCounter &dependency, Job *job)
+{
+	{
+		// the last job finishing takes the list under the same lock, so
+		// either it sees this job or we see the counter at zero.
+		std::lock_guard<std::mutex> lock(dependency.continuationLock);
+		if (!dependency.done())
+		{
+			job->next = dependency.continuations;
+			dependency.continuations = job;
+			return;
+		}
+	}
+	schedule(job);
+}
+
+void
+JobSystem::execute(Job *job)
+{
+	job->function(*job);
+	job->destroy(*job);
+
+	JobCounter *counter = job->counter;
+	job->pool->release(job);
+	if (counter == nullptr)
+		return;
+
+	// all but the last job just decrement. the last one decrements under
+	// the lock, and wait() takes that lock before returning, so the counter
+	// stays alive until the continuations are taken.
+	int64_t pending = counter->pending.load(std::memory_order_relaxed);
+	while (pending > 1 &&
+		   !counter->pending.compare_exchange_weak(pending, pending - 1,
+												   std::memory_order_acq_rel,
+												   std::memory_order_relaxed))
+		;
+	if (pending > 1)
+		return;
+
+	Job *continuations = nullptr;
+	{
+		std::lock_guard<std::mutex> lock(counter->continuationLock);
+		if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			continuations = counter->continuations;
+			counter->continuations = nullptr;
+		}
+	}
+	while (continuations != nullptr)
+	{
+		Job *next = continuations->next;
+		continuations->next = nullptr;
+		schedule(continuations);
+		continuations = next;
+	}
+}
+
+Job *
+JobSystem::findJob(unsigned int index)
+{
+	if (Job *job = threads[index]->deque.pop())
+		return job;
+
+	// steal round robin, starting after our own deque.
+	unsigned int count = threads.size();
+	for (unsigned int i = 1; i < count; i++)
+		if (Job *job = threads[(index + i) % count]->deque.steal())
+			return job;
+	return nullptr;
+}
+
+void
+JobSystem::workerMain(unsigned int index)
+{
+	currentThread = index;
+	unsigned int idleRounds = 0;
+	while (running.load(std::memory_order_relaxed))
+	{
+		uint64_t seenPushes = pushes.load(std::memory_order_seq_cst);
+		if (Job *job = findJob(index))
+		{
+			execute(job);
+			idleRounds = 0;
+			continue;
+		}
+		if (++idleRounds < spinRounds)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		// a push after findJob() changed the count, then there is no sleep.
+		std::unique_lock<std::mutex> lock(sleepLock);
+		sleeping.fetch_add(1, std::memory_order_seq_cst);
+		wakeUp.wait(lock,
+					[&]()
+					{
+						return !running.load(std::memory_order_relaxed) ||
+							   pushes.load(std::memory_order_seq_cst) !=
+								   seenPushes;
+					});
+		sleeping.fetch_sub(1, std::memory_order_seq_cst);
+		idleRounds = 0;
+	}
+}
@@ -0,0 +1,76 @@
+#include "Latency.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace
+{
+
+struct Percentiles
+{
+	float p50, p90, p99, max;
+};
+
+Percentiles
+percentiles(const std::vector<float> &samples, std::size_t count,
+			std::vector<float> &sorted)
+{
+	sorted.assign(samples.begin(), samples.begin() + count);
+	std::sort(sorted.begin(), sorted.end());
+	auto at = [&](std::size_t percent)
+	{ return sorted[std::min(count - 1, count * percent / 100)]; };
+	return {at(50), at(90), at(99), sorted.back()};
+}
+
+} // namespace
+
+LatencyStats::LatencyStats(unsigned int reportEvery)
+	: reportEvery(reportEvery), oldest(historySize), newest(historySize),
+	  sorted(historySize)
+{
+}
+
+void
+LatencyStats::latched(Clock::time_point firstEvent, Clock::time_point lastEvent)
+{
+	// latching again before the swap keeps the oldest event.
+	if (!pending)
+		first = firstEvent;
+	last = lastEvent;
+	pending = true;
+}
+
+void
+LatencyStats::presented(Clock::time_point now)
+{
+	if (!pending)
+		return;
+	pending = false;
+
+	oldest[next] = std::chrono::duration<float, std::milli>(now - first).count();
+	newest[next] = std::chrono::duration<float, std::milli>(now - last).count();
+	next = (next + 1) % historySize;
+	frames++;
+
+	if (reportEvery != 0 && frames % reportEvery == 0)
+		report();
+}
+
+void
+LatencyStats::report() const
+{
+	std::size_t count = std::min<uint64_t>(frames, historySize);
+	if (count == 0)
+		return;
+
+	Percentiles old = percentiles(oldest, count, sorted);
+	Percentiles recent = percentiles(newest, count, sorted);
+	spdlog::info("Input to swap latency over {} frames with input:", count);
+	spdlog::info("  oldest event  p50 {:.2f} p90 {:.2f} p99 {:.2f} max "
+				 "{:.2f} ms",
+				 old.p50, old.p90, old.p99, old.max);
+	spdlog::info("  newest event  p50 {:.2f} p90 {:.2f} p99 {:.2f} max "
+				 "{:.2f} ms",
+				 recent.p50, recent.p90, recent.p99, recent.max);
+}
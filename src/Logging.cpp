@@ -0,0 +1,35 @@
+#include "Logging.hpp"
+
+#include <spdlog/async.h>
+#include <spdlog/sinks/stdout_color_sinks.h>
+
+AsyncLogging::AsyncLogging(const LoggingSettings &settings)
+{
+	// one thread keeps the messages in order.
+	spdlog::init_thread_pool(settings.queueSize, 1);
+	// unnamed like the default logger it replaces, the output looks the same.
+	std::shared_ptr<spdlog::logger> logger =
+		std::make_shared<spdlog::async_logger>(
+			"", std::make_shared<spdlog::sinks::stdout_color_sink_mt>(),
+			spdlog::thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+	logger->set_level(settings.level);
+	// errors show up right away, the rest when the worker gets to them.
+	logger->flush_on(spdlog::level::err);
+	spdlog::set_default_logger(logger);
+}
+
+AsyncLogging::~AsyncLogging()
+{
+	// later messages, e.g. from static destructors, are written directly.
+	std::shared_ptr<spdlog::logger> async = spdlog::default_logger();
+	std::shared_ptr<spdlog::logger> logger =
+		std::make_shared<spdlog::logger>(
+			async->name(),
+			std::make_shared<spdlog::sinks::stdout_color_sink_mt>());
+	logger->set_level(async->level());
+	spdlog::set_default_logger(logger);
+
+	// the pool thread writes out what is queued before it exits.
+	async.reset();
+	spdlog::details::registry::instance().set_tp(nullptr);
+}
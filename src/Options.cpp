@@ -0,0 +1,332 @@
+#include "Options.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace
+{
+
+void
+printUsage(const char *program)
+{
+	spdlog::info("usage: {} [options]\n"
+				 "  --objects N          number of objects in the scene\n"
+				 "  --distribution NAME  tutorial, uniform, clustered, grid "
+				 "or city\n"
+				 "  --seed N             scene random seed\n"
+				 "  --extent F           half size of the scene, 0 = auto\n"
+				 "  --clusters N         cluster count for clustered scenes\n"
+				 "  --meshes N           number of different meshes\n"
+				 "  --materials N        number of different materials\n"
+				 "  --dynamic F          fraction of animated objects [0, 1]\n"
+				 "  --workers N          job system threads, 0 = auto\n"
+				 "  --submit MODE        uniform or instanced matrices\n"
+				 "  --sim-rate HZ        simulation ticks per second\n"
+				 "  --vsync MODE         off, on or adaptive\n"
+				 "  --redraw MODE        continuous or on-demand\n"
+				 "  --upscale MODE       native, bilinear or sharpen; all "
+				 "but native\n"
+				 "                       scale the resolution dynamically\n"
+				 "  --gpu-budget MS      gpu time per frame, 0 = from --fps\n"
+				 "  --min-scale F        lowest render scale (0, 1]\n"
+				 "  --sharpness F        strength of the sharpen upscale\n"
+				 "  --upload-kb N        KiB of assets uploaded per frame, 0 = "
+				 "all at once\n"
+				 "  --budget-draws N     draw calls per frame, only reported\n"
+				 "  --budget-triangles N triangles per frame, only reported\n"
+				 "  --budget-upload-kb N KiB of instance data uploaded per frame, "
+				 "0 = unlimited\n"
+				 "  --budget-cpu MS      cpu time per frame, 0 = unlimited\n"
+				 "  --budget-gpu MS      gpu time per frame, 0 = unlimited\n"
+				 "  --frames-in-flight N frames queued ahead of the gpu, 1-4\n"
+				 "  --fps N              frame limit, 0 = none\n"
+				 "  --pacing-every N     frames between frame time reports\n"
+				 "  --latency-every N    measure input latency, report every "
+				 "N frames\n"
+				 "  --hitch-factor F     trace frames over F x the median, 0 = "
+				 "off\n"
+				 "  --hitch-frames N     frames kept for a hitch trace\n"
+				 "  --hitch-dir PATH     where hitch traces are written\n"
+				 "  --gl-load MODE       full or lazy GL function loading\n"
+				 "  --gl-debug SEVERITY  debug context, log driver messages of "
+				 "notification,\n"
+				 "                       low, medium or high severity and up\n"
+				 "  --gl-stats MODE      count or time every GL call\n"
+				 "  --gl-stats-every N   frames between GL call reports\n"
+				 "  --gl-stats-top N     GL functions listed per report\n"
+				 "  --log-level NAME     trace, debug, info, warn, err, critical "
+				 "or off\n"
+				 "  --capture PATH       record the GL calls for the replay tool\n"
+				 "  --capture-frames N   frames to record, 0 = until exit",
+				 program);
+}
+
+// KiB options are stored in bytes.
+constexpr unsigned long long maxKiB =
+	std::numeric_limits<unsigned long long>::max() / 1024;
+
+} // namespace
+
+bool
+parseUnsigned(const char *text, unsigned long long &value)
+{
+	// strtoull takes "-1" and wraps it around.
+	if (*text < '0' || *text > '9')
+		return false;
+	char *end = nullptr;
+	errno = 0;
+	value = std::strtoull(text, &end, 10);
+	return *end == '\0' && errno == 0;
+}
+
+unsigned int
+clampWorkers(unsigned long long workers)
+{
+	unsigned int limit = std::max(1u, std::thread::hardware_concurrency());
+	if (workers <= limit)
+		return static_cast<unsigned int>(workers);
+	spdlog::warn("{} workers requested, using {}, one per hardware thread",
+				 workers, limit);
+	return limit;
+}
+
+bool
+parseFloat(const char *text, float &value)
+{
+	char *end = nullptr;
+	value = std::strtof(text, &end);
+	return end != text && *end == '\0';
+}
+
+ParseResult
+parseOptions(int argc, char **argv, Options &options)
+{
+	SceneDesc &scene = options.scene;
+	for (int i = 1; i < argc; i++)
+	{
+		const char *arg = argv[i];
+		if (std::strcmp(arg, "--help") == 0 || std::strcmp(arg, "-h") == 0)
+		{
+			printUsage(argv[0]);
+			return ParseResult::Help;
+		}
+
+		if (i + 1 >= argc)
+		{
+			spdlog::error("Missing value for option {}", arg);
+			return ParseResult::Error;
+		}
+		const char *value = argv[++i];
+
+		unsigned long long number = 0;
+		bool ok = true;
+		if (std::strcmp(arg, "--objects") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			scene.objectCount = number;
+		}
+		else if (std::strcmp(arg, "--distribution") == 0)
+			ok = parseSceneDistribution(value, scene.distribution);
+		else if (std::strcmp(arg, "--seed") == 0)
+		{
+			ok = parseUnsigned(value, number) &&
+				 number <= std::numeric_limits<uint32_t>::max();
+			scene.seed = static_cast<uint32_t>(number);
+		}
+		else if (std::strcmp(arg, "--extent") == 0)
+			ok = parseFloat(value, scene.extent) && scene.extent >= 0.0f &&
+				 std::isfinite(scene.extent);
+		else if (std::strcmp(arg, "--clusters") == 0)
+		{
+			ok = parseUnsigned(value, number) &&
+				 number <= std::numeric_limits<unsigned int>::max();
+			scene.clusterCount = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--meshes") == 0)
+		{
+			ok = parseUnsigned(value, number) &&
+				 number <= std::numeric_limits<unsigned int>::max();
+			scene.meshVariety = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--materials") == 0)
+		{
+			ok = parseUnsigned(value, number) &&
+				 number <= std::numeric_limits<unsigned int>::max();
+			scene.materialVariety = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--dynamic") == 0)
+			ok = parseFloat(value, scene.dynamicRatio) &&
+				 scene.dynamicRatio >= 0.0f && scene.dynamicRatio <= 1.0f;
+		else if (std::strcmp(arg, "--workers") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.workers = clampWorkers(number);
+		}
+		else if (std::strcmp(arg, "--submit") == 0)
+			ok = parseSubmitMode(value, options.submit);
+		else if (std::strcmp(arg, "--sim-rate") == 0)
+		{
+			float rate = 0.0f;
+			ok = parseFloat(value, rate) && rate > 0.0f;
+			options.simulationRate = rate;
+		}
+		else if (std::strcmp(arg, "--frames-in-flight") == 0)
+		{
+			ok = parseUnsigned(value, number) && number >= 1 &&
+				 number <= FrameSync::maxFramesInFlight;
+			options.framesInFlight = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--upscale") == 0)
+			ok = parseUpscaleMode(value, options.resolution.upscale);
+		else if (std::strcmp(arg, "--gpu-budget") == 0)
+		{
+			float budget = 0.0f;
+			ok = parseFloat(value, budget) && budget >= 0.0f;
+			options.resolution.budgetMs = budget;
+		}
+		else if (std::strcmp(arg, "--min-scale") == 0)
+			ok = parseFloat(value, options.resolution.minScale) &&
+				 options.resolution.minScale > 0.0f &&
+				 options.resolution.minScale <= 1.0f;
+		else if (std::strcmp(arg, "--sharpness") == 0)
+			ok = parseFloat(value, options.resolution.sharpness);
+		else if (std::strcmp(arg, "--upload-kb") == 0)
+		{
+			ok = parseUnsigned(value, number) && number <= maxKiB;
+			options.uploadBudget = number * 1024;
+		}
+		else if (std::strcmp(arg, "--budget-draws") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.budget.drawCalls = number;
+		}
+		else if (std::strcmp(arg, "--budget-triangles") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.budget.triangles = number;
+		}
+		else if (std::strcmp(arg, "--budget-upload-kb") == 0)
+		{
+			ok = parseUnsigned(value, number) && number <= maxKiB;
+			options.budget.uploadBytes = number * 1024;
+		}
+		else if (std::strcmp(arg, "--budget-cpu") == 0)
+		{
+			float budget = 0.0f;
+			ok = parseFloat(value, budget) && budget >= 0.0f;
+			options.budget.cpuMs = budget;
+		}
+		else if (std::strcmp(arg, "--budget-gpu") == 0)
+		{
+			float budget = 0.0f;
+			ok = parseFloat(value, budget) && budget >= 0.0f;
+			options.budget.gpuMs = budget;
+		}
+		else if (std::strcmp(arg, "--redraw") == 0)
+			ok = parseRedrawMode(value, options.redraw);
+		else if (std::strcmp(arg, "--vsync") == 0)
+			ok = parseVsyncMode(value, options.pacing.vsync);
+		else if (std::strcmp(arg, "--fps") == 0)
+		{
+			float rate = 0.0f;
+			ok = parseFloat(value, rate) && rate >= 0.0f;
+			options.pacing.targetRate = rate;
+		}
+		else if (std::strcmp(arg, "--pacing-every") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.pacing.reportEvery = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--latency-every") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.latencyStats = true;
+			options.latencyReportEvery = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--hitch-factor") == 0)
+		{
+			float factor = 0.0f;
+			ok = parseFloat(value, factor) && (factor == 0.0f || factor > 1.0f);
+			options.hitch.factor = factor;
+		}
+		else if (std::strcmp(arg, "--hitch-frames") == 0)
+		{
+			ok = parseUnsigned(value, number) && number != 0;
+			options.hitch.history = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--hitch-dir") == 0)
+			options.hitch.directory = value;
+		else if (std::strcmp(arg, "--gl-load") == 0)
+			ok = parseGLLoadMode(value, options.glLoad);
+		else if (std::strcmp(arg, "--gl-debug") == 0)
+		{
+			options.glDebug.enabled = true;
+			ok = parseGLDebugSeverity(value, options.glDebug.logSeverity);
+		}
+		else if (std::strcmp(arg, "--gl-stats") == 0)
+		{
+			options.glStats = true;
+			options.glInstrument.timeCalls = std::strcmp(value, "time") == 0;
+			ok = options.glInstrument.timeCalls ||
+				 std::strcmp(value, "count") == 0;
+		}
+		else if (std::strcmp(arg, "--gl-stats-every") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.glInstrument.reportEvery =
+				static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--gl-stats-top") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.glInstrument.topN = static_cast<unsigned int>(number);
+		}
+		else if (std::strcmp(arg, "--log-level") == 0)
+		{
+			options.logging.level = spdlog::level::from_str(value);
+			ok = options.logging.level != spdlog::level::off ||
+				 std::strcmp(value, "off") == 0;
+		}
+		else if (std::strcmp(arg, "--capture") == 0)
+			options.capturePath = value;
+		else if (std::strcmp(arg, "--capture-frames") == 0)
+		{
+			ok = parseUnsigned(value, number);
+			options.captureFrames = static_cast<unsigned int>(number);
+		}
+		else
+		{
+			spdlog::error("Unknown option {}", arg);
+			printUsage(argv[0]);
+			return ParseResult::Error;
+		}
+
+		if (!ok)
+		{
+			spdlog::error("Invalid value '{}' for option {}", value, arg);
+			return ParseResult::Error;
+		}
+	}
+
+	// no quality level changes what the scene submits.
+	if (options.budget.drawCalls != 0 || options.budget.triangles != 0)
+		spdlog::warn("No quality level reduces draw calls or triangles, their "
+					 "budgets are only reported");
+
+	// leave a tenth of the frame to the rest of the gpu work.
+	if (options.resolution.budgetMs == 0.0)
+	{
+		double rate = options.pacing.targetRate > 0.0
+						  ? options.pacing.targetRate
+						  : 60.0;
+		options.resolution.budgetMs = 0.9 * 1000.0 / rate;
+	}
+	return ParseResult::Run;
+}
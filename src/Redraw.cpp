@@ -0,0 +1,69 @@
+#include "Redraw.hpp"
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+#include <cstring>
+
+const char *
+redrawModeName(RedrawMode mode)
+{
+	return mode == RedrawMode::OnDemand ? "on-demand" : "continuous";
+}
+
+bool
+parseRedrawMode(const char *name, RedrawMode &mode)
+{
+	if (std::strcmp(name, "continuous") == 0)
+		mode = RedrawMode::Continuous;
+	else if (std::strcmp(name, "on-demand") == 0)
+		mode = RedrawMode::OnDemand;
+	else
+		return false;
+	return true;
+}
+
+RedrawTracker::RedrawTracker(RedrawMode mode, double settle)
+	: redrawMode(mode),
+	  settleTime(std::chrono::duration_cast<Clock::duration>(
+		  std::chrono::duration<double>(settle)))
+{
+}
+
+bool
+RedrawTracker::needsRedraw(const SimulationState &state, uint64_t inputEvents,
+						   bool animating, Clock::time_point now)
+{
+	if (redrawMode == RedrawMode::Continuous)
+		return true;
+
+	// input reaches the camera a tick later and is interpolated over one
+	// more, keep drawing until that passed.
+	if (inputEvents != seenEvents)
+	{
+		seenEvents = inputEvents;
+		settleUntil = now + settleTime;
+	}
+	// the camera is plain floats, an exact compare finds any change.
+	if (std::memcmp(&state.camera, &lastCamera, sizeof(Camera)) != 0)
+		settleUntil = now + settleTime;
+
+	return invalid || animating || now < settleUntil;
+}
+
+void
+RedrawTracker::drawn(const SimulationState &state)
+{
+	lastCamera = state.camera;
+	invalid = false;
+	frames++;
+}
+
+void
+RedrawTracker::waitForEvents(double timeout)
+{
+	waits++;
+	glfwWaitEventsTimeout(timeout);
+}
@@ -0,0 +1,423 @@
+#include "Renderer.hpp"
+#include "GLDebug.hpp"
+#include "Startup.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <spdlog/spdlog.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+/* clang-format off */
+// all vertics of the meshes: a cube, then a pyramid.
+const float vertices[] = {
+	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+	0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+	0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+	0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+	-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+	-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+	0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+	0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+	0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
+	-0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
+	-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+
+	-0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+	-0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+	-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+	-0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+	0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+	0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+	0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+	0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+	0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+	0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+
+	-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+	0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
+	0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+	0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+	-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+	-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
+
+	-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+	0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
+	0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+	0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
+	-0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
+	-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
+
+	// square pyramid, base first.
+	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+	0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+	0.5f, -0.5f,  0.5f,  1.0f, 1.0f,
+	0.5f, -0.5f,  0.5f,  1.0f, 1.0f,
+	-0.5f, -0.5f,  0.5f,  0.0f, 1.0f,
+	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+
+	-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+	0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+	0.0f,  0.5f,  0.0f,  0.5f, 1.0f,
+
+	0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
+	0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+	0.0f,  0.5f,  0.0f,  0.5f, 1.0f,
+
+	0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+	-0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
+	0.0f,  0.5f,  0.0f,  0.5f, 1.0f,
+
+	-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
+	-0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
+	0.0f,  0.5f,  0.0f,  0.5f, 1.0f
+};
+
+// tints multiplied into the textures, white keeps the tutorial look.
+const glm::vec3 materials[] = {
+	glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(1.0f, 0.6f, 0.6f),
+	glm::vec3(0.6f, 1.0f, 0.6f), glm::vec3(0.6f, 0.6f, 1.0f),
+	glm::vec3(1.0f, 1.0f, 0.5f), glm::vec3(0.5f, 1.0f, 1.0f),
+	glm::vec3(1.0f, 0.5f, 1.0f), glm::vec3(0.7f, 0.7f, 0.7f)};
+/* clang-format on */
+
+const Mesh meshes[Renderer::meshCount] = {{0, 36}, {36, 18}};
+
+static_assert(sizeof(materials) / sizeof(glm::vec3) == Renderer::materialCount,
+			  "materialCount does not match the material table");
+
+// the instance matrix takes one attribute location per column.
+constexpr GLuint instanceLocation = 2;
+
+// binding point of the Camera uniform block.
+constexpr GLuint cameraBinding = 0;
+
+// the Camera block, std140 lays the two matrices out back to back.
+struct CameraBlock
+{
+	glm::mat4 view;
+	glm::mat4 projection;
+};
+
+// past this many ranges one upload of their span is cheaper.
+constexpr std::size_t maxUploadRanges = 64;
+
+void
+decodeImage(TextureImage &image)
+{
+	int nrChannels;
+	// the flag is per thread, the jobs decode on any worker.
+	stbi_set_flip_vertically_on_load_thread(true);
+	unsigned char *data =
+		stbi_load(image.path, &image.width, &image.height, &nrChannels, 3);
+	if (data)
+	{
+		image.pixels.assign(data,
+							data + std::size_t(image.width) * image.height * 3);
+	}
+	else
+	{
+		image.width = image.height = 0;
+		spdlog::error("Failed to load texture {}", image.path);
+	}
+	stbi_image_free(data);
+}
+
+// the pixels reach the gpu over the next frames.
+unsigned int
+createTexture(TextureImage &image, UploadScheduler &uploads)
+{
+	unsigned int texture;
+	glGenTextures(1, &texture);
+
+	if (image.width != 0)
+		uploads.uploadTexture(texture, GL_RGB, image.width, image.height,
+							  GL_RGB, GL_UNSIGNED_BYTE, std::move(image.pixels),
+							  UploadPriority::Visible);
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	labelGLObject(GL_TEXTURE, texture, image.path);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
+					GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return texture;
+}
+
+} // namespace
+
+const char *
+submitModeName(SubmitMode mode)
+{
+	return mode == SubmitMode::Instanced ? "instanced" : "uniform";
+}
+
+bool
+parseSubmitMode(const char *name, SubmitMode &mode)
+{
+	if (std::strcmp(name, "uniform") == 0)
+		mode = SubmitMode::Uniform;
+	else if (std::strcmp(name, "instanced") == 0)
+		mode = SubmitMode::Instanced;
+	else
+		return false;
+	return true;
+}
+
+void
+loadRendererAssets(JobSystem &jobs, RendererAssets &assets, JobCounter &loaded,
+				   StartupTimeline *timeline)
+{
+	auto measure = [timeline](const char *name, auto &&step)
+	{
+		if (timeline != nullptr)
+			timeline->measure(name, step);
+		else
+			step();
+	};
+	jobs.run(
+		[&assets, measure]()
+		{
+			measure("read scene shaders",
+					[&assets]()
+					{
+						assets.shader =
+							readShaderSource(SOURCE_DIR "shader.vert",
+											 SOURCE_DIR "shader.frag");
+					});
+		},
+		&loaded);
+
+	const char *const paths[] = {ASSETS_DIR "container.jpg",
+								 ASSETS_DIR "awesomeface.jpg"};
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		TextureImage *image = &assets.textures[i];
+		image->path = paths[i];
+		jobs.run([image, measure]()
+				 { measure(image->path, [image]() { decodeImage(*image); }); },
+				 &loaded);
+	}
+}
+
+Renderer::Renderer(const Scene &scene, SubmitMode mode,
+				   const FrameSync &frames, UploadScheduler &uploads,
+				   RendererAssets &assets)
+	: scene(scene), mode(mode), frames(frames), shaderProgram(assets.shader)
+{
+	// generating the textures of the decoded images.
+	texture0 = createTexture(assets.textures[0], uploads);
+	texture1 = createTexture(assets.textures[1], uploads);
+
+	glGenVertexArrays(1, &VAO); // just like vbo
+	glGenBuffers(1, &VBO);		// generate vbo buffer id via opengl.
+
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER,
+				 VBO); // binding VBO to GL_ARRAY_BUFFER as VAO.
+	// a few KiB every draw needs, not worth spreading over frames: queued
+	// behind the textures the first frames would draw undefined vertices.
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	labelGLObject(GL_VERTEX_ARRAY, VAO, "scene");
+	labelGLObject(GL_BUFFER, VBO, "scene vertices");
+
+	// linking vertex attribut into VAO.
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
+						  (void *)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
+						  (void *)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	if (mode == SubmitMode::Instanced)
+	{
+		// filled by uploadInstances, the pointers are set per draw group.
+		glGenBuffers(1, &instanceVBO);
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		glBufferData(GL_ARRAY_BUFFER,
+					 scene.objects.size() * sizeof(glm::mat4), nullptr,
+					 GL_DYNAMIC_DRAW);
+		labelGLObject(GL_BUFFER, instanceVBO, "instance matrices");
+		for (GLuint column = 0; column < 4; column++)
+		{
+			glEnableVertexAttribArray(instanceLocation + column);
+			glVertexAttribDivisor(instanceLocation + column, 1);
+		}
+	}
+
+	// one camera slot per frame in flight.
+	GLint alignment = 256;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	cameraSlotSize =
+		(sizeof(CameraBlock) + alignment - 1) / alignment * alignment;
+	glGenBuffers(1, &cameraUBO);
+	glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+	glBufferData(GL_UNIFORM_BUFFER, cameraSlotSize * frames.framesInFlight(),
+				 nullptr, GL_STREAM_DRAW);
+	labelGLObject(GL_BUFFER, cameraUBO, "camera");
+
+	shaderProgram.use();
+	labelGLObject(GL_PROGRAM, shaderProgram.ID, "scene");
+	shaderProgram.bindUniformBlock("Camera", cameraBinding);
+	shaderProgram.setInt("texture0", 0);
+	shaderProgram.setInt("texture1", 1);
+	shaderProgram.setBool("instanced", mode == SubmitMode::Instanced);
+	modelLocation = shaderProgram.location("model");
+	tintLocation = shaderProgram.location("tint");
+
+	// enable first renderer, last show.
+	glEnable(GL_DEPTH_TEST);
+}
+
+Renderer::~Renderer()
+{
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &cameraUBO);
+	if (instanceVBO != 0)
+		glDeleteBuffers(1, &instanceVBO);
+	glDeleteTextures(1, &texture0);
+	glDeleteTextures(1, &texture1);
+}
+
+void
+Renderer::draw(const glm::mat4 &view, const glm::mat4 &projection,
+			   const TransformSystem &transforms)
+{
+	prepare(transforms);
+	submit(view, projection, transforms);
+}
+
+void
+Renderer::prepare(const TransformSystem &transforms)
+{
+	frameStats = RenderStats();
+
+	// rendering
+	glClearColor(0.2f, 0.3f, 0.3f, 1.0f); // background
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	// binding texture
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, texture0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, texture1);
+
+	// activate shader
+	shaderProgram.use();
+
+	glBindVertexArray(VAO); // rendering
+	if (mode == SubmitMode::Instanced)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		uploadInstances(transforms);
+	}
+}
+
+void
+Renderer::submit(const glm::mat4 &view, const glm::mat4 &projection,
+				 const TransformSystem &transforms)
+{
+	// the gpu is done with this slot (FrameSync waited for it), so the
+	// write needs no synchronization by the driver.
+	GLintptr offset = frames.frameIndex() * cameraSlotSize;
+	glBindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+	void *mapped = glMapBufferRange(
+		GL_UNIFORM_BUFFER, offset, sizeof(CameraBlock),
+		GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT |
+			GL_MAP_UNSYNCHRONIZED_BIT);
+	if (mapped != nullptr)
+	{
+		CameraBlock camera = {view, projection};
+		std::memcpy(mapped, &camera, sizeof(camera));
+		glUnmapBuffer(GL_UNIFORM_BUFFER);
+	}
+	glBindBufferRange(GL_UNIFORM_BUFFER, cameraBinding, cameraUBO, offset,
+					  sizeof(CameraBlock));
+
+	const std::vector<glm::mat4> &matrices = transforms.matrices();
+	for (const DrawGroup &group : transforms.groups())
+	{
+		shaderProgram.setVec3(tintLocation, materials[group.material]);
+		const Mesh &mesh = meshes[group.mesh];
+		if (mode == SubmitMode::Instanced)
+		{
+			// gl 4.1 has no base instance, the pointers start at the group.
+			std::size_t instanceOffset = group.first * sizeof(glm::mat4);
+			for (GLuint column = 0; column < 4; column++)
+				glVertexAttribPointer(
+					instanceLocation + column, 4, GL_FLOAT, GL_FALSE,
+					sizeof(glm::mat4),
+					(void *)(instanceOffset + column * sizeof(glm::vec4)));
+			glDrawArraysInstanced(GL_TRIANGLES, mesh.first, mesh.count,
+								  group.count);
+			frameStats.drawCalls++;
+			frameStats.triangles += uint64_t(mesh.count / 3) * group.count;
+			continue;
+		}
+
+		for (uint32_t slot = group.first; slot < group.first + group.count;
+			 slot++)
+		{
+			shaderProgram.setMat4(modelLocation, matrices[slot]);
+			glDrawArrays(GL_TRIANGLES, mesh.first, mesh.count); // rendering
+		}
+		frameStats.drawCalls += group.count;
+		frameStats.triangles += uint64_t(mesh.count / 3) * group.count;
+	}
+}
+
+// only the slots rewritten by the last update, the instance buffer is bound.
+void
+Renderer::uploadInstances(const TransformSystem &transforms)
+{
+	const SlotRange *ranges = transforms.updatedRanges();
+	std::size_t rangeCount = transforms.updatedRangeCount();
+	if (rangeCount == 0)
+		return;
+
+	const glm::mat4 *matrices = transforms.matrices().data();
+	if (rangeCount > maxUploadRanges)
+	{
+		uint32_t first = ranges[0].first;
+		uint32_t last =
+			ranges[rangeCount - 1].first + ranges[rangeCount - 1].count;
+		glBufferSubData(GL_ARRAY_BUFFER, first * sizeof(glm::mat4),
+						(last - first) * sizeof(glm::mat4), matrices + first);
+		frameStats.uploadBytes += (last - first) * sizeof(glm::mat4);
+		return;
+	}
+	for (std::size_t i = 0; i < rangeCount; i++)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, ranges[i].first * sizeof(glm::mat4),
+						ranges[i].count * sizeof(glm::mat4),
+						matrices + ranges[i].first);
+		frameStats.uploadBytes += ranges[i].count * sizeof(glm::mat4);
+	}
+}
+
+void
+Renderer::setLodBias(float bias)
+{
+	for (unsigned int texture : {texture0, texture1})
+	{
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_LOD_BIAS, bias);
+	}
+}
+
+float
+Renderer::farPlane() const
+{
+	return std::max(100.0f, 2.0f * scene.radius);
+}
@@ -0,0 +1,281 @@
+#include "SceneGenerator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace
+{
+
+// std::uniform_real_distribution and friends are implementation defined, so
+// the floats are derived from the raw mt19937 stream which is not.
+class SceneRandom final
+{
+  public:
+	explicit SceneRandom(uint32_t seed) : engine(seed) {}
+
+	// [0, 1)
+	float next() { return (engine() >> 8) * (1.0f / 16777216.0f); }
+
+	float range(float low, float high) { return low + (high - low) * next(); }
+
+	unsigned int index(unsigned int count)
+	{
+		return count > 1 ? engine() % count : 0;
+	}
+
+	// box-muller, one sample per call is plenty here.
+	float gaussian()
+	{
+		float u1 = std::max(next(), 1e-7f);
+		float u2 = next();
+		return std::sqrt(-2.0f * std::log(u1)) *
+			   std::cos(6.28318530718f * u2);
+	}
+
+	glm::vec3 unitVector()
+	{
+		float z = range(-1.0f, 1.0f);
+		float a = range(0.0f, 6.28318530718f);
+		float r = std::sqrt(1.0f - z * z);
+		return glm::vec3(r * std::cos(a), r * std::sin(a), z);
+	}
+
+  private:
+	std::mt19937 engine;
+};
+
+const glm::vec3 tutorialPositions[] = {
+	glm::vec3(0.0f, 0.0f, 0.0f),	glm::vec3(2.0f, 5.0f, -15.0f),
+	glm::vec3(-1.5f, -2.2f, -2.5f), glm::vec3(-3.8f, -2.0f, -12.3f),
+	glm::vec3(2.4f, -0.4f, -3.5f),	glm::vec3(-1.7f, 3.0f, -7.5f),
+	glm::vec3(1.3f, -2.0f, -2.5f),	glm::vec3(1.5f, 2.0f, -2.5f),
+	glm::vec3(1.5f, 0.2f, -1.5f),	glm::vec3(-1.3f, 1.0f, -1.5f)};
+
+float
+defaultExtent(const SceneDesc &desc)
+{
+	if (desc.extent > 0.0f)
+		return desc.extent;
+	// keeps the density roughly constant: about one object per 4 units^3.
+	return std::max(10.0f,
+					1.6f * std::cbrt(static_cast<float>(desc.objectCount)));
+}
+
+void
+placeTutorial(const SceneDesc &desc, SceneRandom &, Scene &scene)
+{
+	std::size_t count = std::min<std::size_t>(
+		desc.objectCount, sizeof(tutorialPositions) / sizeof(glm::vec3));
+	for (std::size_t i = 0; i < count; i++)
+	{
+		SceneObject &object = scene.objects[i];
+		object.position = tutorialPositions[i];
+		object.rotationAngle = -55.0f;
+		object.rotationAxis = glm::normalize(glm::vec3(1.0f, -1.0f, 0.0f));
+	}
+	scene.objects.resize(count);
+}
+
+void
+placeUniform(const SceneDesc &desc, SceneRandom &random, Scene &scene)
+{
+	float extent = defaultExtent(desc);
+	for (SceneObject &object : scene.objects)
+	{
+		object.position = glm::vec3(random.range(-extent, extent),
+									random.range(-extent, extent),
+									random.range(-extent, extent));
+		object.rotationAngle = random.range(0.0f, 360.0f);
+		object.rotationAxis = random.unitVector();
+	}
+}
+
+void
+placeClustered(const SceneDesc &desc, SceneRandom &random, Scene &scene)
+{
+	float extent = defaultExtent(desc);
+	unsigned int clusterCount = std::max(1u, desc.clusterCount);
+
+	std::vector<glm::vec3> centers(clusterCount);
+	for (glm::vec3 &center : centers)
+		center = glm::vec3(random.range(-extent, extent),
+						   random.range(-extent, extent),
+						   random.range(-extent, extent));
+
+	// spread chosen so the blobs overlap a little but stay distinct.
+	float sigma = extent / (2.0f * std::cbrt(static_cast<float>(clusterCount)));
+	for (SceneObject &object : scene.objects)
+	{
+		const glm::vec3 &center = centers[random.index(clusterCount)];
+		object.position = center + sigma * glm::vec3(random.gaussian(),
+													 random.gaussian(),
+													 random.gaussian());
+		object.rotationAngle = random.range(0.0f, 360.0f);
+		object.rotationAxis = random.unitVector();
+	}
+}
+
+void
+placeGrid(const SceneDesc &desc, SceneRandom &, Scene &scene)
+{
+	float extent = defaultExtent(desc);
+	std::size_t side = static_cast<std::size_t>(
+		std::ceil(std::cbrt(static_cast<double>(scene.objects.size()))));
+	side = std::max<std::size_t>(side, 1);
+	float spacing = side > 1 ? 2.0f * extent / (side - 1) : 0.0f;
+
+	for (std::size_t i = 0; i < scene.objects.size(); i++)
+	{
+		SceneObject &object = scene.objects[i];
+		std::size_t x = i % side;
+		std::size_t y = (i / side) % side;
+		std::size_t z = i / (side * side);
+		object.position = glm::vec3(-extent + x * spacing,
+									-extent + y * spacing,
+									-extent + z * spacing);
+		object.rotationAngle = 0.0f;
+		object.rotationAxis = glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+}
+
+// lots are laid out in 4x4 blocks separated by one lot wide streets, the
+// buildings get taller towards the center of the city.
+void
+placeCity(const SceneDesc &desc, SceneRandom &random, Scene &scene)
+{
+	constexpr std::size_t lotsPerBlock = 4;
+	constexpr float lotSize = 2.0f;
+
+	std::size_t lotsPerSide = static_cast<std::size_t>(
+		std::ceil(std::sqrt(static_cast<double>(scene.objects.size()))));
+	lotsPerSide = std::max<std::size_t>(lotsPerSide, 1);
+	// one street for every block.
+	float citySize =
+		lotSize * (lotsPerSide + lotsPerSide / lotsPerBlock) * 0.5f;
+	float extent = desc.extent > 0.0f ? desc.extent : citySize;
+	float scaleToExtent = extent / std::max(citySize, 1.0f);
+
+	for (std::size_t i = 0; i < scene.objects.size(); i++)
+	{
+		SceneObject &object = scene.objects[i];
+		std::size_t lx = i % lotsPerSide;
+		std::size_t lz = i / lotsPerSide;
+		float x = (lx + lx / lotsPerBlock) * lotSize - citySize;
+		float z = (lz + lz / lotsPerBlock) * lotSize - citySize;
+
+		float distance = std::sqrt(x * x + z * z) / std::max(citySize, 1.0f);
+		float height =
+			1.0f + 24.0f * std::exp(-3.0f * distance) * random.range(0.2f, 1.0f);
+		float width = lotSize * random.range(0.6f, 0.9f);
+		float depth = lotSize * random.range(0.6f, 0.9f);
+
+		object.scale = glm::vec3(width, height, depth) * scaleToExtent;
+		object.position =
+			glm::vec3(x, 0.5f * height, z) * scaleToExtent;
+		object.rotationAngle = 0.0f;
+		object.rotationAxis = glm::vec3(0.0f, 1.0f, 0.0f);
+	}
+}
+
+} // namespace
+
+Scene
+generateScene(const SceneDesc &desc)
+{
+	Scene scene;
+	scene.desc = desc;
+	scene.objects.resize(desc.objectCount);
+
+	SceneObject defaults;
+	defaults.position = glm::vec3(0.0f);
+	defaults.rotationAngle = 0.0f;
+	defaults.rotationAxis = glm::vec3(0.0f, 1.0f, 0.0f);
+	defaults.mesh = 0;
+	defaults.material = 0;
+	defaults.scale = glm::vec3(1.0f);
+	defaults.dynamic = 0;
+	std::fill(scene.objects.begin(), scene.objects.end(), defaults);
+
+	SceneRandom random(desc.seed);
+	switch (desc.distribution)
+	{
+		case SceneDistribution::Tutorial:
+			placeTutorial(desc, random, scene);
+			break;
+		case SceneDistribution::Uniform:
+			placeUniform(desc, random, scene);
+			break;
+		case SceneDistribution::Clustered:
+			placeClustered(desc, random, scene);
+			break;
+		case SceneDistribution::Grid:
+			placeGrid(desc, random, scene);
+			break;
+		case SceneDistribution::City:
+			placeCity(desc, random, scene);
+			break;
+	}
+
+	// a separate stream so the variety settings do not move the objects.
+	SceneRandom variety(desc.seed ^ 0x9e3779b9u);
+	unsigned int meshVariety = std::max(1u, desc.meshVariety);
+	unsigned int materialVariety = std::max(1u, desc.materialVariety);
+	float radius = 0.0f;
+	for (SceneObject &object : scene.objects)
+	{
+		object.mesh = static_cast<uint16_t>(variety.index(meshVariety));
+		object.material =
+			static_cast<uint16_t>(variety.index(materialVariety));
+		if (variety.next() < desc.dynamicRatio)
+		{
+			object.dynamic = 1;
+			scene.dynamicCount++;
+		}
+
+		float objectRadius =
+			glm::length(object.position) + glm::length(object.scale);
+		radius = std::max(radius, objectRadius);
+	}
+	scene.radius = radius;
+
+	return scene;
+}
+
+const char *
+sceneDistributionName(SceneDistribution distribution)
+{
+	switch (distribution)
+	{
+		case SceneDistribution::Tutorial:
+			return "tutorial";
+		case SceneDistribution::Uniform:
+			return "uniform";
+		case SceneDistribution::Clustered:
+			return "clustered";
+		case SceneDistribution::Grid:
+			return "grid";
+		case SceneDistribution::City:
+			return "city";
+	}
+	return "unknown";
+}
+
+bool
+parseSceneDistribution(const char *name, SceneDistribution &distribution)
+{
+	const SceneDistribution all[] = {
+		SceneDistribution::Tutorial, SceneDistribution::Uniform,
+		SceneDistribution::Clustered, SceneDistribution::Grid,
+		SceneDistribution::City};
+	for (SceneDistribution candidate : all)
+	{
+		if (std::strcmp(name, sceneDistributionName(candidate)) == 0)
+		{
+			distribution = candidate;
+			return true;
+		}
+	}
+	return false;
+}
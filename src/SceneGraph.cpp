@@ -0,0 +1,171 @@
+#include "SceneGraph.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+
+// nodes per job within a level.
+constexpr std::size_t batchSize = 2048;
+
+glm::mat4
+localMatrix(const glm::vec3 &position, const glm::quat &rotation,
+			const glm::vec3 &scale)
+{
+	// translate * rotate * scale without the general matrix products.
+	glm::mat4 matrix = glm::mat4_cast(rotation);
+	matrix[0] *= scale.x;
+	matrix[1] *= scale.y;
+	matrix[2] *= scale.z;
+	matrix[3] = glm::vec4(position, 1.0f);
+	return matrix;
+}
+
+template <typename T>
+void
+permute(std::vector<T> &values, const std::vector<uint32_t> &order)
+{
+	std::vector<T> permuted(values.size());
+	for (std::size_t i = 0; i < order.size(); i++)
+		permuted[i] = values[order[i]];
+	values.swap(permuted);
+}
+
+} // namespace
+
+NodeId
+SceneGraph::addNode(NodeId parent, const LocalTransform &local)
+{
+	// appending keeps parents before children, only the levels get mixed.
+	NodeId node = nodeOf.size();
+	parents.push_back(parent == noParent ? noParent : orderOf[parent]);
+	positions.push_back(local.position);
+	rotations.push_back(local.rotation);
+	scales.push_back(local.scale);
+	worlds.emplace_back(1.0f);
+	dirty.push_back(1);
+	nodeOf.push_back(node);
+	orderOf.push_back(node);
+	ordered = false;
+	return node;
+}
+
+LocalTransform
+SceneGraph::local(NodeId node) const
+{
+	uint32_t index = orderOf[node];
+	return {positions[index], rotations[index], scales[index]};
+}
+
+void
+SceneGraph::setLocal(NodeId node, const LocalTransform &local)
+{
+	uint32_t index = orderOf[node];
+	positions[index] = local.position;
+	rotations[index] = local.rotation;
+	scales[index] = local.scale;
+	dirty[index] = 1;
+}
+
+void
+SceneGraph::update()
+{
+	if (!ordered)
+		linearize();
+	updated = updateRange(0, nodeOf.size());
+	std::fill(dirty.begin(), dirty.end(), 0);
+}
+
+void
+SceneGraph::update(JobSystem &jobs)
+{
+	if (!ordered)
+		linearize();
+
+	// a level only reads the flags and matrices of the one before.
+	std::atomic<std::size_t> count{0};
+	for (std::size_t level = 0; level + 1 < levelStarts.size(); level++)
+		jobs.parallelFor(levelStarts[level], levelStarts[level + 1], batchSize,
+						 [this, &count](std::size_t first, std::size_t last)
+						 {
+							 count.fetch_add(updateRange(first, last),
+											 std::memory_order_relaxed);
+						 });
+	updated = count.load();
+	std::fill(dirty.begin(), dirty.end(), 0);
+}
+
+std::size_t
+SceneGraph::updateRange(std::size_t first, std::size_t last)
+{
+	std::size_t count = 0;
+	for (std::size_t i = first; i < last; i++)
+	{
+		uint32_t parent = parents[i];
+		if (parent != noParent)
+			dirty[i] |= dirty[parent];
+		if (!dirty[i])
+			continue;
+
+		glm::mat4 matrix = localMatrix(positions[i], rotations[i], scales[i]);
+		worlds[i] = parent == noParent ? matrix : worlds[parent] * matrix;
+		count++;
+	}
+	return count;
+}
+
+void
+SceneGraph::linearize()
+{
+	std::size_t count = nodeOf.size();
+
+	// children of every node, as ranges into one array.
+	std::vector<uint32_t> childStarts(count + 1, 0);
+	for (uint32_t parent : parents)
+		if (parent != noParent)
+			childStarts[parent + 1]++;
+	for (std::size_t i = 0; i < count; i++)
+		childStarts[i + 1] += childStarts[i];
+	std::vector<uint32_t> children(childStarts[count]);
+	std::vector<uint32_t> fill(childStarts.begin(), childStarts.end() - 1);
+	for (uint32_t i = 0; i < count; i++)
+		if (parents[i] != noParent)
+			children[fill[parents[i]]++] = i;
+
+	// breadth first walk, old order index of every new position.
+	std::vector<uint32_t> order;
+	order.reserve(count);
+	for (uint32_t i = 0; i < count; i++)
+		if (parents[i] == noParent)
+			order.push_back(i);
+	levelStarts.assign(1, 0);
+	for (std::size_t begin = 0; begin < order.size();)
+	{
+		std::size_t end = order.size();
+		levelStarts.push_back(end);
+		for (std::size_t i = begin; i < end; i++)
+			for (uint32_t c = childStarts[order[i]];
+				 c < childStarts[order[i] + 1]; c++)
+				order.push_back(children[c]);
+		begin = end;
+	}
+
+	std::vector<uint32_t> newIndex(count);
+	for (uint32_t i = 0; i < count; i++)
+		newIndex[order[i]] = i;
+
+	for (uint32_t &parent : parents)
+		if (parent != noParent)
+			parent = newIndex[parent];
+	permute(parents, order);
+	permute(positions, order);
+	permute(rotations, order);
+	permute(scales, order);
+	permute(worlds, order);
+	permute(dirty, order);
+	permute(nodeOf, order);
+	for (uint32_t i = 0; i < count; i++)
+		orderOf[nodeOf[i]] = i;
+	ordered = true;
+}
@@ -1,10 +1,14 @@
 #include "Shader.hpp"
 #include <fstream>
 
-Shader::Shader(const char *vertexPath, const char *fragmentPath)
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+
+ShaderSource
+readShaderSource(const char *vertexPath, const char *fragmentPath)
 {
-	std::string vertexCode;
-	std::string fragmentCode;
+	ShaderSource source;
 	std::ifstream vShaderFile;
 	std::ifstream fShaderFile;
 
@@ -24,17 +28,26 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
 		vShaderFile.close();
 		fShaderFile.close();
 
-		vertexCode = vShaderStream.str();
-		fragmentCode = fShaderStream.str();
+		source.vertex = vShaderStream.str();
+		source.fragment = fShaderStream.str();
 	}
 	catch (std::ifstream::failure &e)
 	{
-		std::cout << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << e.what()
-				  << std::endl;
+		spdlog::error("Failed to read shader {} or {}: {}", vertexPath,
+					  fragmentPath, e.what());
 	}
+	return source;
+}
 
-	const char *vShaderCode = vertexCode.c_str();
-	const char *fShaderCode = fragmentCode.c_str();
+Shader::Shader(const char *vertexPath, const char *fragmentPath)
+	: Shader(readShaderSource(vertexPath, fragmentPath))
+{
+}
+
+Shader::Shader(const ShaderSource &source)
+{
+	const char *vShaderCode = source.vertex.c_str();
+	const char *fShaderCode = source.fragment.c_str();
 
 	// compile shaders
 	unsigned int vertex, fragment;
@@ -71,34 +84,30 @@ void Shader::use()
 	glUseProgram(ID);
 }
 
-void Shader::setBool(const std::string &name, bool value) const
+void Shader::setBool(const char *name, bool value) const
 {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+	glUniform1i(glGetUniformLocation(ID, name), (int)value);
 }
-void Shader::setFloat(const std::string &name, float value) const
+void Shader::setFloat(const char *name, float value) const
 {
-	glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+	glUniform1f(glGetUniformLocation(ID, name), value);
 }
-void Shader::setInt(const std::string &name, int value) const
+void Shader::setInt(const char *name, int value) const
 {
-	glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+	glUniform1i(glGetUniformLocation(ID, name), value);
 }
-void Shader::checkCompileErrors(unsigned int shader, std::string type)
+void Shader::checkCompileErrors(unsigned int shader, const char *type)
 {
 	int success;
 	char infoLog[1024];
-	if (type != "PROGRAM")
+	if (std::strcmp(type, "PROGRAM") != 0)
 	{
 		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
 		if (!success)
 		{
 			glGetShaderInfoLog(shader, 1024, NULL, infoLog);
-			std::cout
-				<< "ERROR::SHADER_COMPILATION_ERROR of type: " << type << "\n"
-				<< infoLog
-				<< "\n -- --------------------------------------------------- "
-				   "-- "
-				<< std::endl;
+			spdlog::error("Shader compilation error of type {}:\n{}", type,
+						  infoLog);
 		}
 	}
 	else
@@ -107,12 +116,7 @@ void Shader::checkCompileErrors(unsigned int shader, std::string type)
 		if (!success)
 		{
 			glGetProgramInfoLog(shader, 1024, NULL, infoLog);
-			std::cout
-				<< "ERROR::PROGRAM_LINKING_ERROR of type: " << type << "\n"
-				<< infoLog
-				<< "\n -- --------------------------------------------------- "
-				   "-- "
-				<< std::endl;
+			spdlog::error("Program linking error:\n{}", infoLog);
 		}
 	}
 }
\ No newline at end of file
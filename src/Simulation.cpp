@@ -0,0 +1,107 @@
+#include "Simulation.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+
+namespace
+{
+
+// ticks run back to back to catch up after a stall, beyond that the
+// simulation skips ahead instead of spiraling.
+constexpr unsigned int maxCatchUpTicks = 5;
+
+} // namespace
+
+Simulation::Simulation(double rate, InputQueue &input, float width,
+					   float height)
+	: tickSeconds(1.0 / std::max(rate, 1.0)),
+	  tickDuration(std::chrono::duration_cast<Clock::duration>(
+		  std::chrono::duration<double>(tickSeconds))),
+	  inputQueue(input)
+{
+	camera = spawnCamera(world, width, height);
+	state.camera = *world.get<Camera>(camera);
+	state.look = *world.get<MouseLook>(camera);
+	latest.due = Clock::now();
+	latest.previous = latest.current = state;
+	thread = std::thread(&Simulation::run, this, latest.due);
+	spdlog::info("Simulation running at {:.0f} Hz", 1.0 / tickSeconds);
+}
+
+Simulation::~Simulation()
+{
+	running.store(false, std::memory_order_relaxed);
+	thread.join();
+}
+
+void
+Simulation::run(Clock::time_point start)
+{
+	Clock::time_point next = start + tickDuration;
+	while (running.load(std::memory_order_relaxed))
+	{
+		std::this_thread::sleep_until(next);
+
+		unsigned int due = 0;
+		Clock::time_point now = Clock::now();
+		while (next <= now && due < maxCatchUpTicks)
+		{
+			tick(next);
+			next += tickDuration;
+			due++;
+		}
+		if (next <= now)
+		{
+			uint64_t behind = (now - next) / tickDuration + 1;
+			dropped.fetch_add(behind, std::memory_order_relaxed);
+			next += behind * tickDuration;
+		}
+	}
+}
+
+void
+Simulation::tick(Clock::time_point due)
+{
+	drainInput(inputQueue, input);
+
+	SimulationState previous = state;
+	float step = static_cast<float>(tickSeconds);
+	moveCameras(world, keyboardDirection(input), step);
+	if (input.cursorMoved)
+		lookCameras(world, input.cursorX, input.cursorY);
+	if (input.scroll != 0.0)
+		zoomCameras(world, input.scroll);
+	state.camera = *world.get<Camera>(camera);
+	state.look = *world.get<MouseLook>(camera);
+	state.time += tickSeconds;
+
+	SimulationSnapshot &snapshot = snapshots.back();
+	snapshot.tick = ticks.load(std::memory_order_relaxed) + 1;
+	snapshot.due = due;
+	snapshot.previous = previous;
+	snapshot.current = state;
+	snapshots.publish();
+	ticks.store(snapshot.tick, std::memory_order_relaxed);
+}
+
+SimulationState
+Simulation::sample(Clock::time_point now)
+{
+	if (snapshots.acquire())
+		latest = snapshots.front();
+
+	// the current state belongs to the end of its tick, show the one a step
+	// earlier so there is always a later state to move towards.
+	float alpha = std::chrono::duration<float>(now - latest.due).count() /
+				  static_cast<float>(tickSeconds);
+	alpha = std::clamp(alpha, 0.0f, 1.0f);
+
+	SimulationState sampled;
+	sampled.time = latest.previous.time +
+				   alpha * (latest.current.time - latest.previous.time);
+	sampled.camera =
+		interpolateCamera(latest.previous.camera, latest.current.camera, alpha);
+	sampled.look = latest.current.look;
+	return sampled;
+}
@@ -0,0 +1,67 @@
+#include "Startup.hpp"
+#include "JobSystem.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+
+double
+millisecondsBetween(StartupTimeline::Clock::time_point begin,
+					StartupTimeline::Clock::time_point end)
+{
+	return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+} // namespace
+
+StartupTimeline::StartupTimeline() : start(Clock::now())
+{
+	steps.reserve(16);
+}
+
+void
+StartupTimeline::record(const char *name, Clock::time_point begin,
+						Clock::time_point end)
+{
+	std::lock_guard<std::mutex> guard(lock);
+	steps.push_back({name, JobSystem::threadIndex(),
+					 millisecondsBetween(start, begin),
+					 millisecondsBetween(start, end)});
+}
+
+void
+StartupTimeline::firstFrame()
+{
+	if (reported)
+		return;
+	reported = true;
+	double totalMs = millisecondsBetween(start, Clock::now());
+
+	std::lock_guard<std::mutex> guard(lock);
+	std::sort(steps.begin(), steps.end(), [](const Step &a, const Step &b)
+			  { return a.beginMs < b.beginMs; });
+	// the work the workers took off the main thread.
+	double workerMs = 0.0;
+	for (const Step &step : steps)
+		if (step.thread != 0)
+			workerMs += step.endMs - step.beginMs;
+	spdlog::info("Time to first frame: {:.1f} ms, {:.1f} ms of work done by "
+				 "the workers",
+				 totalMs, workerMs);
+	for (const Step &step : steps)
+	{
+		// files are named by their path, the directory is the same for all.
+		const char *slash = std::strrchr(step.name, '/');
+		const char *name = slash != nullptr ? slash + 1 : step.name;
+		if (step.thread == 0)
+			spdlog::info("  {:<28} main     {:8.2f} - {:8.2f} ms", name,
+						 step.beginMs, step.endMs);
+		else
+			spdlog::info("  {:<28} worker {:<2}{:8.2f} - {:8.2f} ms", name,
+						 step.thread, step.beginMs, step.endMs);
+	}
+}
@@ -0,0 +1,147 @@
+#include "TrackedAllocator.hpp"
+#include "AllocationCounter.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+
+// stored right before every allocation.
+struct Header
+{
+	std::size_t size;
+	std::size_t offset; // from the malloc'd block to the allocation.
+};
+
+static_assert(sizeof(Header) <= TrackedAllocator::defaultAlignment,
+			  "the header has to fit the default alignment");
+
+Header *
+headerOf(void *memory)
+{
+	return reinterpret_cast<Header *>(static_cast<unsigned char *>(memory) -
+									  sizeof(Header));
+}
+
+struct Registry
+{
+	std::mutex lock;
+	std::vector<std::unique_ptr<TrackedAllocator>> allocators;
+};
+
+// created on first use and never destroyed, static objects of other
+// translation units may allocate before main and free after it.
+Registry &
+registry()
+{
+	static Registry *instance = new Registry();
+	return *instance;
+}
+
+} // namespace
+
+TrackedAllocator::TrackedAllocator(const char *name) : allocatorName(name) {}
+
+void
+TrackedAllocator::added(std::size_t size)
+{
+	std::size_t now = live.fetch_add(size, std::memory_order_relaxed) + size;
+	std::size_t seen = peak.load(std::memory_order_relaxed);
+	while (now > seen &&
+		   !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed))
+	{
+	}
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	liveAllocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void *
+TrackedAllocator::allocate(std::size_t size, std::size_t align)
+{
+	// malloc already returns memory of the default alignment, larger ones
+	// need room to move the allocation up.
+	std::size_t extra = align <= defaultAlignment
+							? defaultAlignment
+							: align + defaultAlignment;
+	unsigned char *block = static_cast<unsigned char *>(std::malloc(size + extra));
+	if (block == nullptr)
+		return nullptr;
+
+	uintptr_t start = reinterpret_cast<uintptr_t>(block) + defaultAlignment;
+	if (align > defaultAlignment)
+		start = (start + align - 1) & ~(uintptr_t(align) - 1);
+	void *memory = reinterpret_cast<void *>(start);
+	*headerOf(memory) = {size, start - reinterpret_cast<uintptr_t>(block)};
+	added(size);
+	return memory;
+}
+
+void *
+TrackedAllocator::reallocate(void *memory, std::size_t size)
+{
+	if (memory == nullptr)
+		return allocate(size);
+
+	Header *header = headerOf(memory);
+	std::size_t oldSize = header->size;
+	unsigned char *block = static_cast<unsigned char *>(
+		std::realloc(static_cast<unsigned char *>(memory) - header->offset,
+					 size + defaultAlignment));
+	if (block == nullptr)
+		return nullptr;
+
+	memory = block + defaultAlignment;
+	headerOf(memory)->size = size;
+	live.fetch_sub(oldSize, std::memory_order_relaxed);
+	liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	added(size);
+	return memory;
+}
+
+void
+TrackedAllocator::free(void *memory)
+{
+	if (memory == nullptr)
+		return;
+
+	Header *header = headerOf(memory);
+	live.fetch_sub(header->size, std::memory_order_relaxed);
+	liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+	std::free(static_cast<unsigned char *>(memory) - header->offset);
+}
+
+TrackedAllocator &
+trackedAllocator(const char *name)
+{
+	Registry &instance = registry();
+	std::lock_guard<std::mutex> lock(instance.lock);
+	for (const std::unique_ptr<TrackedAllocator> &allocator :
+		 instance.allocators)
+		if (allocator->name() == name)
+			return *allocator;
+	instance.allocators.push_back(std::make_unique<TrackedAllocator>(name));
+	return *instance.allocators.back();
+}
+
+void
+reportMemory()
+{
+	Registry &instance = registry();
+	std::lock_guard<std::mutex> lock(instance.lock);
+	spdlog::info("Memory: {:.1f} MiB in {} operator new calls",
+				 heapAllocatedBytes() / double(1 << 20), heapAllocationCount());
+	for (const std::unique_ptr<TrackedAllocator> &allocator :
+		 instance.allocators)
+		spdlog::info("  {:<16} {:10.1f} KiB live {:10.1f} KiB peak "
+					 "{:8} live / {} total allocations",
+					 allocator->name(), allocator->liveBytes() / 1024.0,
+					 allocator->peakBytes() / 1024.0,
+					 allocator->liveAllocationCount(),
+					 allocator->allocationCount());
+}
@@ -0,0 +1,125 @@
+#include "TransformSystem.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <numeric>
+
+namespace
+{
+
+// objects per job, large enough to hide the scheduling cost.
+constexpr std::size_t batchSize = 1024;
+
+glm::mat4
+modelMatrix(const SceneObject &object, float time)
+{
+	// dynamic objects keep spinning around their axis.
+	float angle = object.rotationAngle;
+	if (object.dynamic)
+		angle += 50.0f * time;
+
+	glm::mat4 model = glm::translate(glm::mat4(1.0f), object.position);
+	model = glm::rotate(model, glm::radians(angle), object.rotationAxis);
+	return glm::scale(model, object.scale);
+}
+
+} // namespace
+
+TransformSystem::TransformSystem(const Scene &scene) : scene(scene)
+{
+	const std::vector<SceneObject> &objects = scene.objects;
+	slotObjects.resize(objects.size());
+	std::iota(slotObjects.begin(), slotObjects.end(), 0u);
+	std::stable_sort(slotObjects.begin(), slotObjects.end(),
+					 [&objects](uint32_t a, uint32_t b)
+					 {
+						 const SceneObject &x = objects[a], &y = objects[b];
+						 if (x.mesh != y.mesh)
+							 return x.mesh < y.mesh;
+						 if (x.material != y.material)
+							 return x.material < y.material;
+						 return (x.dynamic != 0) < (y.dynamic != 0);
+					 });
+
+	objectSlots.resize(objects.size());
+	slotMatrices.resize(objects.size());
+	dirty.assign(objects.size(), 1);
+	for (uint32_t slot = 0; slot < slotObjects.size(); slot++)
+	{
+		const SceneObject &object = objects[slotObjects[slot]];
+		objectSlots[slotObjects[slot]] = slot;
+		if (object.dynamic)
+			dynamicSlots.push_back(slot);
+		else
+			dirtySlots.push_back(slot);
+
+		if (drawGroups.empty() || drawGroups.back().mesh != object.mesh ||
+			drawGroups.back().material != object.material)
+			drawGroups.push_back({object.mesh, object.material, slot, 0});
+		drawGroups.back().count++;
+	}
+}
+
+void
+TransformSystem::update(JobSystem &jobs, float time, LinearArena &frame)
+{
+	// dynamicSlots is sorted, the dirty static slots get merged into it.
+	std::sort(dirtySlots.begin(), dirtySlots.end());
+	updateCount = dynamicSlots.size() + dirtySlots.size();
+	uint32_t *updateSlots = frame.allocateArray<uint32_t>(updateCount);
+	std::merge(dynamicSlots.begin(), dynamicSlots.end(), dirtySlots.begin(),
+			   dirtySlots.end(), updateSlots);
+	dirtySlots.clear();
+
+	const SceneObject *objects = scene.objects.data();
+	jobs.parallelFor(0, updateCount, batchSize,
+					 [&](std::size_t first, std::size_t last)
+					 {
+						 for (std::size_t i = first; i < last; i++)
+						 {
+							 uint32_t slot = updateSlots[i];
+							 slotMatrices[slot] =
+								 modelMatrix(objects[slotObjects[slot]], time);
+							 dirty[slot] = 0;
+						 }
+					 });
+
+	// at most one range per updated slot, the arena makes that free.
+	ranges = frame.allocateArray<SlotRange>(updateCount);
+	rangeCount = 0;
+	for (std::size_t i = 0; i < updateCount; i++)
+	{
+		uint32_t slot = updateSlots[i];
+		if (rangeCount != 0 &&
+			ranges[rangeCount - 1].first + ranges[rangeCount - 1].count == slot)
+			ranges[rangeCount - 1].count++;
+		else
+			ranges[rangeCount++] = {slot, 1};
+	}
+}
+
+void
+TransformSystem::holdFrame()
+{
+	ranges = nullptr;
+	rangeCount = 0;
+	updateCount = 0;
+}
+
+std::size_t
+TransformSystem::frameBytes() const
+{
+	return slotObjects.size() * (sizeof(uint32_t) + sizeof(SlotRange)) +
+		   2 * alignof(std::max_align_t);
+}
+
+void
+TransformSystem::markDirty(std::size_t object)
+{
+	uint32_t slot = objectSlots[object];
+	if (dirty[slot] || scene.objects[object].dynamic)
+		return;
+	dirty[slot] = 1;
+	dirtySlots.push_back(slot);
+}
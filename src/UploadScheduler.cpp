@@ -0,0 +1,174 @@
+#include "UploadScheduler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+
+namespace
+{
+
+// smaller buffer chunks cost more in call overhead than they smooth out.
+constexpr uint64_t minBufferChunk = 16 * 1024;
+
+} // namespace
+
+UploadScheduler::UploadScheduler(uint64_t budgetBytes)
+	: budgetBytes(budgetBytes)
+{
+}
+
+void
+UploadScheduler::uploadTexture(GLuint texture, GLint internalFormat,
+							   GLsizei width, GLsizei height, GLenum format,
+							   GLenum type, UploadBytes pixels,
+							   UploadPriority priority, bool mipmaps)
+{
+	// only the base level exists until the last band is in.
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format,
+				 type, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+	// no rows to upload, less than a byte per row included. the storage
+	// is all there is, done right away.
+	std::size_t rowBytes = height > 0 ? pixels.size() / height : 0;
+	if (width <= 0 || rowBytes == 0)
+		return;
+
+	Upload upload;
+	upload.object = texture;
+	upload.texture = true;
+	upload.mipmaps = mipmaps;
+	upload.width = width;
+	upload.height = height;
+	upload.format = format;
+	upload.type = type;
+	upload.rowBytes = rowBytes;
+	upload.offset = 0;
+	upload.bytes = std::move(pixels);
+	uploadStats.pendingBytes += upload.bytes.size();
+	queues[static_cast<unsigned int>(priority)].push_back(std::move(upload));
+	uploadStats.queued = ++queued;
+}
+
+void
+UploadScheduler::uploadBuffer(GLuint buffer, GLintptr offset,
+							  UploadBytes bytes, UploadPriority priority)
+{
+	if (bytes.empty())
+		return;
+
+	Upload upload;
+	upload.object = buffer;
+	upload.texture = false;
+	upload.mipmaps = false;
+	upload.width = upload.height = 0;
+	upload.format = upload.type = GL_NONE;
+	upload.rowBytes = 0;
+	upload.offset = offset;
+	upload.bytes = std::move(bytes);
+	uploadStats.pendingBytes += upload.bytes.size();
+	queues[static_cast<unsigned int>(priority)].push_back(std::move(upload));
+	uploadStats.queued = ++queued;
+}
+
+uint64_t
+UploadScheduler::advance(Upload &upload, uint64_t limit, bool force)
+{
+	if (!upload.texture)
+	{
+		uint64_t size = std::min<uint64_t>(std::max(limit, minBufferChunk),
+										   upload.bytes.size() - upload.done);
+		if (size > limit && !force)
+			return 0;
+		// the copy target leaves the bindings of the renderer alone.
+		glBindBuffer(GL_COPY_WRITE_BUFFER, upload.object);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, upload.offset + upload.done,
+						size, upload.bytes.data() + upload.done);
+		upload.done += size;
+		return size;
+	}
+
+	std::size_t rows = std::min<std::size_t>(limit / upload.rowBytes,
+											 upload.height - upload.done);
+	if (rows == 0 && !force)
+		return 0;
+	rows = std::max<std::size_t>(rows, 1);
+	glBindTexture(GL_TEXTURE_2D, upload.object);
+	// the rows are tightly packed.
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	glTexSubImage2D(GL_TEXTURE_2D, 0, 0, upload.done, upload.width, rows,
+					upload.format, upload.type,
+					upload.bytes.data() + upload.done * upload.rowBytes);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	upload.done += rows;
+
+	if (upload.done == std::size_t(upload.height) && upload.mipmaps)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 1000);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	return rows * upload.rowBytes;
+}
+
+void
+UploadScheduler::upload(uint64_t limit)
+{
+	uploadStats.frameBytes = 0;
+	bool full = false;
+	for (std::deque<Upload> &queue : queues)
+	{
+		while (!queue.empty() && !full)
+		{
+			Upload &front = queue.front();
+			uint64_t bytes = advance(front, limit - uploadStats.frameBytes,
+									 uploadStats.frameBytes == 0);
+			uploadStats.frameBytes += bytes;
+			full = bytes == 0 || uploadStats.frameBytes >= limit;
+			std::size_t total =
+				front.texture ? std::size_t(front.height) : front.bytes.size();
+			if (front.done == total)
+			{
+				queue.pop_front();
+				queued--;
+			}
+		}
+	}
+
+	uploadStats.queued = queued;
+	uploadStats.pendingBytes -= uploadStats.frameBytes;
+	uploadStats.totalBytes += uploadStats.frameBytes;
+	if (uploadStats.frameBytes != 0)
+	{
+		uploadStats.frames++;
+		SPDLOG_DEBUG("Uploaded {} KiB, {} uploads with {} KiB pending",
+					 uploadStats.frameBytes / 1024, queued,
+					 uploadStats.pendingBytes / 1024);
+	}
+}
+
+void
+UploadScheduler::process()
+{
+	upload(budgetBytes != 0 ? budgetBytes
+							: std::numeric_limits<uint64_t>::max());
+}
+
+void
+UploadScheduler::flush()
+{
+	upload(std::numeric_limits<uint64_t>::max());
+}
+
+void
+UploadScheduler::report() const
+{
+	if (uploadStats.frames == 0)
+		return;
+	spdlog::info("Uploads: {} KiB over {} frames, budget {}",
+				 uploadStats.totalBytes / 1024, uploadStats.frames,
+				 budgetBytes == 0
+					 ? std::string("unlimited")
+					 : fmt::format("{} KiB per frame", budgetBytes / 1024));
+}
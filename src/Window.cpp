@@ -0,0 +1,69 @@
+#include "Window.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+
+namespace
+{
+
+double
+millisecondsSince(std::chrono::steady_clock::time_point &start)
+{
+	auto now = std::chrono::steady_clock::now();
+	double ms = std::chrono::duration<double, std::milli>(now - start).count();
+	start = now;
+	return ms;
+}
+
+} // namespace
+
+GLFWwindow *
+createWindow(int width, int height, const char *title, bool visible,
+			 bool debug, GLLoadMode load)
+{
+	auto start = std::chrono::steady_clock::now();
+	// glfw initialize and configure.
+	if (!glfwInit())
+	{
+		spdlog::error("Failed to initialize GLFW");
+		return NULL;
+	}
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+	glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, debug ? GLFW_TRUE : GLFW_FALSE);
+
+#ifdef __APPLE__
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+	double initMs = millisecondsSince(start);
+
+	// glfw window creatation
+	GLFWwindow *window = glfwCreateWindow(width, height, title, NULL, NULL);
+	if (window == NULL)
+	{
+		spdlog::error("Failed to create GLFW window");
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+	double contextMs = millisecondsSince(start);
+
+	// glad to manage the pointer of opengl
+	if (!loadGL(load, (GLADloadproc)glfwGetProcAddress))
+	{
+		spdlog::error("Failed to initialize GLAD");
+		glfwTerminate();
+		return NULL;
+	}
+	double loadMs = millisecondsSince(start);
+	spdlog::info("GL {}.{} context ready in {:.1f} ms: glfw init {:.1f} ms, "
+				 "window and context {:.1f} ms, {} load {:.2f} ms ({} "
+				 "functions resolved)",
+				 GLVersion.major, GLVersion.minor, initMs + contextMs + loadMs,
+				 initMs, contextMs, glLoadModeName(load), loadMs,
+				 resolvedGLFunctionCount());
+	return window;
+}
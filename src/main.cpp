@@ -6,74 +6,116 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
-#include "Shader.hpp"
-
-#include <iostream>
+#include "Allocators.hpp"
+#include "BudgetGovernor.hpp"
+#include "DynamicResolution.hpp"
+#include "FramePacer.hpp"
+#include "FrameSync.hpp"
+#include "GLCapture.hpp"
+#include "GLDebug.hpp"
+#include "GLInstrument.hpp"
+#include "HitchDetector.hpp"
+#include "Input.hpp"
+#include "JobSystem.hpp"
+#include "Latency.hpp"
+#include "Logging.hpp"
+#include "Options.hpp"
+#include "Redraw.hpp"
+#include "Renderer.hpp"
+#include "SceneGenerator.hpp"
+#include "Simulation.hpp"
+#include "Startup.hpp"
+#include "TrackedAllocator.hpp"
+#include "TransformSystem.hpp"
+#include "UploadScheduler.hpp"
+#include "Window.hpp"
+
+#include <algorithm>
+#include <chrono>
 // clang-format on
 
-// some settings for camera space
-glm::vec3 cameraPos = glm::vec3(0.0f, 0.0f, 3.0f);
-glm::vec3 cameraFront = glm::vec3(0.0f, 0.0f, -1.0f);
-glm::vec3 cameraUp = glm::vec3(0.0f, 1.0f, 0.0f);
-
-// for calcuating the delat time.
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
-
-bool firstMouse = true;
-float yaw = -90.0f;
-float pitch = 0.0f;
-float lastX = 400, lastY = 300;
-float fov = 45.0f;
-
 constexpr unsigned int SRC_WIDTH = 800;
 constexpr unsigned int SRC_HEIGHT = 600;
 
+// set by the resize and refresh callbacks, the next frame has to be drawn.
+bool windowDamaged = false;
+
 void
 framebuffer_size_callback(GLFWwindow *window, int witdh, int height);
 void
-processInput(GLFWwindow *window);
-void
-mouse_callback(GLFWwindow *window, double xpos, double ypos);
-void
-scroll_callback(GLFWwindow *window, double xoffset, double yoffset);
+window_refresh_callback(GLFWwindow *window);
 
 int
-main()
+main(int argc, char **argv)
 {
-	// glfw initialize and configure.
-	glfwInit();
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-
-#ifdef __APPLE__
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
-
-	// glfw window creatation
-	GLFWwindow *window =
-		glfwCreateWindow(SRC_WIDTH, SRC_HEIGHT, "LearnOpenGL", NULL, NULL);
+	Options options;
+	ParseResult parsed = parseOptions(argc, argv, options);
+	if (parsed != ParseResult::Run)
+		return parsed == ParseResult::Help ? 0 : 2;
+	// from here on the worker threads log too, none of them waits on I/O.
+	// declared first, it outlives every thread that logs.
+	AsyncLogging logging(options.logging);
+	// from here to the first swap.
+	StartupTimeline startup;
+
+	// everything that needs no GL context starts on the workers right away
+	// and overlaps the window creation, the GL side waits for its inputs.
+	JobSystem jobs(options.workers);
+	options.scene.meshVariety =
+		std::min(options.scene.meshVariety, Renderer::meshCount);
+	options.scene.materialVariety =
+		std::min(options.scene.materialVariety, Renderer::materialCount);
+	Scene scene;
+	JobCounter sceneGenerated;
+	jobs.run(
+		[&scene, &options, &startup]()
+		{
+			startup.measure("generate scene", [&scene, &options]()
+							{ scene = generateScene(options.scene); });
+		},
+		&sceneGenerated);
+	RendererAssets assets;
+	ShaderSource upscaleSource;
+	JobCounter assetsLoaded;
+	loadRendererAssets(jobs, assets, assetsLoaded, &startup);
+	if (options.resolution.upscale == UpscaleMode::Sharpen)
+		jobs.run(
+			[&upscaleSource, &startup]()
+			{
+				startup.measure("read upscale shaders",
+								[&upscaleSource]()
+								{
+									upscaleSource = readShaderSource(
+										SOURCE_DIR "upscale.vert",
+										SOURCE_DIR "upscale.frag");
+								});
+			},
+			&assetsLoaded);
+
+	GLFWwindow *window = NULL;
+	startup.measure("window and GL context",
+					[&window, &options]()
+					{
+						window = createWindow(
+							SRC_WIDTH, SRC_HEIGHT, "LearnOpenGL", true,
+							options.glDebug.enabled, options.glLoad);
+					});
 	if (window == NULL)
 	{
-		spdlog::error("Failed to create GLFW window");
-		glfwTerminate();
+		// the jobs write into the locals above.
+		jobs.wait(sceneGenerated);
+		jobs.wait(assetsLoaded);
 		return -1;
 	}
-	glfwMakeContextCurrent(window);
 
-	// glad to manage the pointer of opengl
-	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
-	{
-		spdlog::error("Failed to initialize GLAD");
-		return -1;
-	}
+	if (options.glDebug.enabled)
+		installGLDebug(options.glDebug);
 
-	// enable first renderer, last show.
-	glEnable(GL_DEPTH_TEST);
+	if (options.glStats)
+		installGLInstrumentation(options.glInstrument);
+	// before any GL state is set up, the replay has to recreate all of it.
+	if (!options.capturePath.empty())
+		startGLCapture(options.capturePath.c_str(), options.captureFrames);
 
 	// settings viewport.
 	int fbWidth, fbHeight;
@@ -81,273 +123,185 @@ main()
 						   &fbHeight); // get actual pixel from window.
 	glViewport(0, 0, fbWidth, fbHeight);
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	glfwSetWindowRefreshCallback(window, window_refresh_callback);
 
 	// settings mouse cursor that stays within the center of the window.
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
-	// the library loading the shader.
-	Shader shaderProgram(SOURCE_DIR "shader.vert", SOURCE_DIR "shader.frag");
-
-	// loading image, and generating texture.
-	unsigned int texture0, texture1;
-	glGenTextures(1, &texture0);
-	glBindTexture(GL_TEXTURE_2D, texture0);
-
-	// loading image and settings texture0
-	int texture0_image_width, texture0_image_height, nrChannels0;
-	stbi_set_flip_vertically_on_load(true);
-	unsigned char *data =
-		stbi_load(ASSETS_DIR "container.jpg", &texture0_image_width,
-				  &texture0_image_height, &nrChannels0, 0);
-
-	if (data)
-	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture0_image_width,
-					 texture0_image_height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		spdlog::error("Failed to load texture");
-	}
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-					GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	stbi_image_free(data);
-
-	// loading image and settings texture0
-	int texture1_image_width, texture1_image_height, nrChannels1;
-	glGenTextures(1, &texture1);
-	glBindTexture(GL_TEXTURE_2D, texture1);
-
-	data = stbi_load(ASSETS_DIR "awesomeface.jpg", &texture1_image_width,
-					 &texture1_image_height, &nrChannels1, 0);
-	if (data)
-	{
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, texture1_image_width,
-					 texture1_image_height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
-	{
-		std::cout << "Failed to load texture" << std::endl;
-	}
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER,
-					GL_LINEAR_MIPMAP_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	stbi_image_free(data);
-
-	/* clang-format off */ 
-	// all vertics in a cube.
-	float vertices[] = {
-		-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
-		0.5f, -0.5f, -0.5f,  1.0f, 0.0f,
-		0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-		0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-		-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
-		-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,
-
-		-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-		0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
-		0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
-		0.5f,  0.5f,  0.5f,  1.0f, 1.0f,
-		-0.5f,  0.5f,  0.5f,  0.0f, 1.0f,
-		-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-
-		-0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-		-0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-		-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-		-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-		-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-		-0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-
-		0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-		0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-		0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-		0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-		0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-		0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-
-		-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-		0.5f, -0.5f, -0.5f,  1.0f, 1.0f,
-		0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
-		0.5f, -0.5f,  0.5f,  1.0f, 0.0f,
-		-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,
-		-0.5f, -0.5f, -0.5f,  0.0f, 1.0f,
-
-		-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,
-		0.5f,  0.5f, -0.5f,  1.0f, 1.0f,
-		0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-		0.5f,  0.5f,  0.5f,  1.0f, 0.0f,
-		-0.5f,  0.5f,  0.5f,  0.0f, 0.0f,
-		-0.5f,  0.5f, -0.5f,  0.0f, 1.0f
-	};
-	/* clang-format on */
-
-	// 10 cubes Positions
-	glm::vec3 cubePositions[] = {
-		glm::vec3(0.0f, 0.0f, 0.0f),	glm::vec3(2.0f, 5.0f, -15.0f),
-		glm::vec3(-1.5f, -2.2f, -2.5f), glm::vec3(-3.8f, -2.0f, -12.3f),
-		glm::vec3(2.4f, -0.4f, -3.5f),	glm::vec3(-1.7f, 3.0f, -7.5f),
-		glm::vec3(1.3f, -2.0f, -2.5f),	glm::vec3(1.5f, 2.0f, -2.5f),
-		glm::vec3(1.5f, 0.2f, -1.5f),	glm::vec3(-1.3f, 1.0f, -1.5f)};
-
-	unsigned int VBO;			// declare vertex attribute object.
-	unsigned int VAO;			// or GLuint. declare the value of the buffer id
-	glGenVertexArrays(1, &VAO); // just like vbo
-	glGenBuffers(1, &VBO);		// generate vbo buffer id via opengl.
-
-	glBindVertexArray(VAO);
-	glBindBuffer(GL_ARRAY_BUFFER,
-				 VBO); // binding VBO to GL_ARRAY_BUFFER as VAO.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-	// linking vertex attribut into VAO.
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-						  (void *)0);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float),
-						  (void *)(3 * sizeof(float)));
-	glEnableVertexAttribArray(1);
-
-	shaderProgram.use();
-	shaderProgram.setInt("texture0", 0);
-	shaderProgram.setInt("texture1", 1);
+	// the camera is simulated on its own thread, the callbacks queue the
+	// input events for it.
+	InputQueue input;
+	installInputCallbacks(window, input);
+	Simulation simulation(options.simulationRate, input, SRC_WIDTH,
+						  SRC_HEIGHT);
+
+	// GL setup in the order its inputs are usually ready: the files, then
+	// the scene. the waits run pending jobs on this thread too.
+	startup.measure("wait for files", [&jobs, &assetsLoaded]()
+					{ jobs.wait(assetsLoaded); });
+	FrameSync frameSync(options.framesInFlight);
+	StartupTimeline::Clock::time_point glBegin = StartupTimeline::Clock::now();
+	DynamicResolution resolution(options.resolution, frameSync, upscaleSource);
+	startup.record("upscale shader", glBegin, StartupTimeline::Clock::now());
+	startup.measure("wait for scene", [&jobs, &sceneGenerated]()
+					{ jobs.wait(sceneGenerated); });
+	spdlog::info("Scene: {} {} objects ({} dynamic), seed {}",
+				 scene.objects.size(),
+				 sceneDistributionName(scene.desc.distribution),
+				 scene.dynamicCount, scene.desc.seed);
+
+	TransformSystem transforms(scene);
+	// assets reach the gpu a slice per frame instead of all in the first.
+	UploadScheduler uploads(options.uploadBudget);
+	glBegin = StartupTimeline::Clock::now();
+	Renderer renderer(scene, options.submit, frameSync, uploads, assets);
+	startup.record("scene shader and buffers", glBegin,
+				   StartupTimeline::Clock::now());
+	// per frame temporaries, the render path itself does not allocate.
+	FrameArena frameArena(transforms.frameBytes() + (64 << 10));
+	FramePacer pacer(options.pacing);
+	RedrawTracker redraw(options.redraw, 3.0 * simulation.step());
+	LatencyStats latency(options.latencyReportEvery);
+	BudgetGovernor governor(options.budget,
+							options.resolution.upscale != UpscaleMode::Native);
+	HitchDetector hitches(options.hitch, jobs);
+	uint64_t frameCount = 0;
 
 	// starting renderering.
 	while (!glfwWindowShouldClose(window))
 	{
-		// calcuate the deltatime that keep each generate speed uniformly.
-		float currentFrame = glfwGetTime();
-		deltaTime = currentFrame - lastFrame;
-		lastFrame = currentFrame;
-
-		// polling input I/O device.
-		processInput(window);
-		glfwSetCursorPosCallback(window, mouse_callback);
-		glfwSetScrollCallback(window, scroll_callback);
-
-		// rendering
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f); // background
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// binding texture
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture0);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, texture1);
-
-		// activate shader
-		shaderProgram.use();
+		// sleeps off the time left to the frame limit.
+		hitches.zone("pace");
+		pacer.waitForNextFrame();
+
+		// the simulation state at this frame.
+		Simulation::Clock::time_point now = Simulation::Clock::now();
+		SimulationState state = simulation.sample(now);
+
+		// nothing changed since the last frame, sleep until something does.
+		if (windowDamaged)
+			redraw.invalidate();
+		windowDamaged = false;
+		if (!redraw.needsRedraw(state, input.pushedEvents(),
+								transforms.needsUpdate() || uploads.pending(),
+								now))
+		{
+			redraw.waitForEvents(0.25);
+			pacer.resume();
+			hitches.resume();
+			continue;
+		}
 
-		//
+		// blocks while the gpu is still frames behind.
+		Simulation::Clock::time_point cpuStart = Simulation::Clock::now();
+		hitches.zone("fence");
+		frameSync.beginFrame();
+		// GL work queued by jobs of the previous frame.
+		hitches.zone("uploads");
+		jobs.drainMainThread();
+		uploads.process();
+		hitches.zone("transforms");
+		frameArena.beginFrame();
+		// at lower quality levels the animation only advances every few
+		// frames, the held frames upload nothing.
+		if (frameCount++ % governor.quality().updateInterval == 0)
+			transforms.update(jobs, state.time, frameArena.current());
+		else
+			transforms.holdFrame();
+		// the scene goes to the scaled offscreen target, if there is one.
+		glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+		hitches.zone("prepare");
+		resolution.beginScene(fbWidth, fbHeight);
+		renderer.prepare(transforms);
+
+		// late latching: poll once more right before the draw calls and turn
+		// the camera towards the newest cursor position.
+		hitches.zone("input");
+		glfwPollEvents();
+		Camera eye = state.camera;
+		double cursorX, cursorY;
+		if (input.latestCursor(cursorX, cursorY))
+			eye = latchCamera(eye, state.look, cursorX, cursorY);
+		Simulation::Clock::time_point firstEvent, lastEvent;
+		if (input.takeEventTimes(firstEvent, lastEvent) &&
+			options.latencyStats)
+			latency.latched(firstEvent, lastEvent);
 
 		// create coordinate system
-		glm::mat4 view; // view matrix: world space -> view space.
-		view = glm::lookAt(cameraPos, cameraPos + cameraFront, cameraUp);
+		glm::mat4 view =
+			cameraView(eye); // view matrix: world space -> view space.
 
 		glm::mat4 projection =
 			glm::mat4(1.0f); // projection matrix: view space -> clip space.
-		projection =
-			glm::perspective(glm::radians(fov), 800.0f / 600.0f, 0.1f, 100.0f);
-		shaderProgram.setMat4("projection", projection);
-		shaderProgram.setMat4("view", view);
-
-		glBindVertexArray(VAO); // rendering
-		for (unsigned int i = 0; i < 10; i++)
+		projection = glm::perspective(glm::radians(eye.fov), 800.0f / 600.0f,
+									  0.1f, renderer.farPlane());
+		hitches.zone("submit");
+		renderer.submit(view, projection, transforms);
+		resolution.endScene();
+		frameSync.endFrame();
+
+		// the fence wait is gpu time, not cpu work.
+		FrameCost cost;
+		cost.drawCalls = renderer.stats().drawCalls;
+		cost.triangles = renderer.stats().triangles;
+		// only the instance uploads, which the update interval of the quality
+		// levels defers. the asset uploads have a budget of their own.
+		cost.uploadBytes = renderer.stats().uploadBytes;
+		cost.cpuMs = std::chrono::duration<double, std::milli>(
+						 Simulation::Clock::now() - cpuStart)
+						 .count() -
+					 frameSync.lastWaitMs();
+		cost.gpuMs = resolution.lastGpuMs();
+		if (governor.update(cost))
 		{
-			glm::mat4 model = glm::mat4(1.0f);
-			model = glm::translate(model, cubePositions[i]);
-			model = glm::rotate(model, glm::radians(-55.0f),
-								glm::vec3(1.0f, -1.0f, 0.0f));
-			shaderProgram.setMat4("model", model);
-			glDrawArrays(GL_TRIANGLES, 0, 36); // rendering
+			renderer.setLodBias(governor.quality().lodBias);
+			// a no-op while the dynamic resolution is off.
+			resolution.setMaxScale(governor.quality().maxRenderScale);
 		}
 
 		// checking
+		hitches.zone("swap");
 		glfwSwapBuffers(window);
-		glfwPollEvents();
+		startup.firstFrame();
+		latency.presented(Simulation::Clock::now());
+		pacer.frameDone();
+		redraw.drawn(state);
+		endGLDebugFrame();
+		hitches.endFrame({cost.gpuMs,
+						  cost.uploadBytes + uploads.stats().frameBytes,
+						  cost.drawCalls, lastFrameGLDebugStats().performance});
+		endGLInstrumentationFrame();
+		endGLCaptureFrame();
 	}
+	if (input.droppedEvents() != 0)
+		spdlog::warn("{} input events dropped, the queue was full",
+					 input.droppedEvents());
+	stopGLCapture();
+	if (redraw.mode() == RedrawMode::OnDemand)
+		spdlog::info("Drew {} frames, idled {} times", redraw.drawnFrames(),
+					 redraw.idleWaits());
+	pacer.report();
+	frameSync.report();
+	uploads.report();
+	if (options.latencyStats)
+		latency.report();
+	reportGLDebug();
+	reportGLInstrumentation();
+	reportMemory();
 	glfwTerminate();
 	return 0;
 }
 
-
 void
 framebuffer_size_callback(GLFWwindow *window, int width, int height)
 {
-	glViewport(0, 0, width, height);
+	// runs from the late latch poll, after beginScene() set the viewport of
+	// this frame. the next beginScene() picks the new size up.
+	windowDamaged = true;
 }
 
 void
-processInput(GLFWwindow *window)
+window_refresh_callback(GLFWwindow *window)
 {
-	const float cameraSpeed = 2.5f * deltaTime;
-	if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-		cameraPos += cameraSpeed * cameraFront;
-	if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-		cameraPos -= cameraSpeed * cameraFront;
-	if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-		cameraPos -=
-			glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
-	if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-		cameraPos +=
-			glm::normalize(glm::cross(cameraFront, cameraUp)) * cameraSpeed;
-
-	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(window, true);
-	}
+	windowDamaged = true;
 }
-
-void
-mouse_callback(GLFWwindow *window, double xpos, double ypos)
-{
-	if (firstMouse)
-	{
-		lastX = xpos;
-		lastY = ypos;
-		firstMouse = false;
-	}
-
-	float xoffset = xpos - lastX;
-	float yoffset = lastY - ypos;
-
-	lastX = xpos;
-	lastY = ypos;
-
-	const float sensitivity = 0.1f;
-	xoffset *= sensitivity;
-	yoffset *= sensitivity;
-
-	yaw += xoffset;
-	pitch += yoffset;
-
-	if (pitch > 89.0f)
-		pitch = 89.0f;
-	if (pitch < -89.0f)
-		pitch = -89.0f;
-
-	glm::vec3 direction;
-	direction.x = cos(glm::radians(yaw)) * cos(glm::radians(pitch));
-	direction.y = sin(glm::radians(pitch));
-	direction.z = sin(glm::radians(yaw)) * cos(glm::radians(pitch));
-	cameraFront = glm::normalize(direction);
-}
-void
-scroll_callback(GLFWwindow *window, double xoffset, double yoffset)
-{
-	fov -= (float)yoffset;
-	if (fov < 1.0f)
-		fov = 1.0f;
-	if (fov > 45.0f)
-		fov = 45.0f;
-}
\ No newline at end of file
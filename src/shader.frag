@@ -7,7 +7,8 @@ in vec2 TexCoord;
 
 uniform sampler2D texture0;
 uniform sampler2D texture1;
+uniform vec3 tint;
 
 void main() {
-    FragColor = mix(texture(texture0, TexCoord), texture(texture1, TexCoord), 0.2);
+    FragColor = mix(texture(texture0, TexCoord), texture(texture1, TexCoord), 0.2) * vec4(tint, 1.0);
 }
\ No newline at end of file
@@ -2,14 +2,21 @@
 
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in mat4 instanceModel; // locations 2 to 5.
 
 out vec2 TexCoord;
 
+// written by the renderer right before the draw calls (late latching).
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+uniform bool instanced;
 
 void main() {
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    mat4 world = instanced ? instanceModel : model;
+    gl_Position = projection * view * world * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
 }
\ No newline at end of file
@@ -0,0 +1,22 @@
+// the single translation unit that compiles the stb_image implementation.
+#include "TrackedAllocator.hpp"
+
+namespace
+{
+
+// decoded images are the staging memory of every texture upload. looked up
+// on first use, images may be decoded before this file's statics are set.
+TrackedAllocator &
+imageAllocator()
+{
+	static TrackedAllocator &allocator = trackedAllocator("stb_image");
+	return allocator;
+}
+
+} // namespace
+
+#define STBI_MALLOC(size) imageAllocator().allocate(size)
+#define STBI_REALLOC(memory, size) imageAllocator().reallocate(memory, size)
+#define STBI_FREE(memory) imageAllocator().free(memory)
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
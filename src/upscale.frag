@@ -0,0 +1,27 @@
+#version 410 core
+
+in vec2 uv;
+out vec4 FragColor;
+
+// the scene was rendered into the lower left `scale` part of the texture.
+uniform sampler2D source;
+uniform vec2 scale;
+uniform vec2 texel;     // 1 / texture size.
+uniform float sharpness; // 0 = plain bilinear.
+
+vec3 sampleSource(vec2 at) {
+    // stay half a texel inside the rendered area, the rest is stale.
+    return texture(source, clamp(at, 0.5 * texel, scale - 0.5 * texel)).rgb;
+}
+
+void main() {
+    vec2 at = uv * scale;
+    vec3 center = sampleSource(at);
+    vec3 neighbors = sampleSource(at + vec2(texel.x, 0.0)) +
+                     sampleSource(at - vec2(texel.x, 0.0)) +
+                     sampleSource(at + vec2(0.0, texel.y)) +
+                     sampleSource(at - vec2(0.0, texel.y));
+    // unsharp mask against the four neighbours.
+    vec3 sharpened = center + sharpness * (4.0 * center - neighbors) * 0.25;
+    FragColor = vec4(clamp(sharpened, 0.0, 1.0), 1.0);
+}